@@ -2,7 +2,7 @@
 
 set -e
 
-gcc -Isrc -std=c99 -pedantic -ggdb3 -Wall -Wextra -Werror -o bin/main \
+gcc -Isrc -std=c99 -pedantic -ggdb3 -Wall -Wextra -Werror -pthread -o bin/main \
   src/html/parse/attr_name.c \
   src/html/parse/attr_value.c \
   src/html/parse/doctype.c \
@@ -12,18 +12,38 @@ gcc -Isrc -std=c99 -pedantic -ggdb3 -Wall -Wextra -Werror -o bin/main \
   src/html/parse/tag_name.c \
   src/html/parse/tag_open.c \
   src/html/attr.c \
+  src/html/attrmap.c \
+  src/html/bloom.c \
+  src/html/build.c \
   src/html/conv.c \
+  src/html/css.c \
+  src/html/extract.c \
   src/html/lex.c \
+  src/html/link.c \
   src/html/node.c \
   src/html/parse.c \
+  src/html/qset.c \
   src/html/query.c \
+  src/html/scan.c \
+  src/html/serial.c \
+  src/html/stat.c \
   src/html/state.c \
+  src/html/stream.c \
+  src/html/tag.c \
+  src/html/tape.c \
+  src/html/trav.c \
   src/html/tree.c \
+  src/html/walk.c \
+  src/html/xpath.c \
   src/text/cmpl.c \
+  src/text/dedup.c \
   src/text/lex.c \
   src/text/parse.c \
   src/text/tree.c \
+  src/text/vocab.c \
   src/blitz.c \
   src/graph.c \
   src/io.c \
+  src/mem.c \
+  src/task.c \
   src/token.c
@@ -12,38 +12,94 @@
  */
 #include "html/conv.h"
 #include "html/parse.h"
+#include "html/trav.h"
 #include "html/tree.h"
 #include "text/cmpl.h"
 #include "text/tree.h"
 #include "io.h"
+#include "mem.h"
+#include "task.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-content_tree_t *dom_tree_expand(dom_tree_t *self)
+#define DOM_TREE_EXPAND_CHUNK (1ul << 4)
+
+/**
+ * @brief A run of consecutive bodies compiled by one task. Each body
+ *        writes its content subtree into its own slot of 'roots'.
+ */
+struct dom_tree_expand_task
 {
-  content_tree_t *tree = NULL;
+  dom_tree_node_t **nodes;
+  content_tree_node_t **roots;
+  uint64_t begin;
+  uint64_t end;
+};
+
+typedef struct dom_tree_expand_task dom_tree_expand_task_t;
+
+static void dom_tree_expand_compile(void *arg)
+{
+  dom_tree_expand_task_t *self = (dom_tree_expand_task_t *)arg;
   content_tree_t *subtree = NULL;
-  content_tree_node_queue_t *content_tree_que = NULL;
+  uint64_t i;
+
+  for (i = self->begin; i < self->end; i++)
+  {
+    subtree = text_compile(self->nodes[i]->body);
+    self->roots[i] = subtree->root;
+
+    subtree->root = NULL;
+    content_tree_destroy(subtree);
+    subtree = NULL;
+  }
+}
+
+content_tree_t *dom_tree_expand(dom_tree_t *self, const uint64_t nthreads)
+{
+  content_tree_t *tree = NULL;
   content_tree_node_t *parent = NULL;
-  dom_tree_node_queue_t *que = NULL;
+  content_tree_node_t **roots = NULL;
+  dom_tree_expand_task_t *tasks = NULL;
+  dom_tree_node_t **nodes = NULL;
   dom_tree_node_t *node = NULL;
+  dom_trav_t *trav = NULL;
+  uint64_t *parents = NULL;
+  uint64_t *que = NULL;
+  size_t cap;
+  size_t quecap;
+  uint64_t count;
+  uint64_t ntasks;
+  uint64_t r;
+  uint64_t w;
   uint64_t i;
+  uint64_t p;
 
   tree = content_tree_new();
-  content_tree_que = content_tree_node_queue_new(CONTENT_TREE_NODE_QUEUE_CAPACITY);
-  que = dom_tree_node_queue_new(DOM_TREE_NODE_QUEUE_CAPACITY);
+  tree->root = content_tree_node_new(self->root->body, (self->root->body != NULL) ? strlen(self->root->body) : 0ul, CONTENT_TREE_NODE_CAPACITY);
 
-  que = dom_tree_node_queue_enqueue(que, self->root);
+  cap = quecap = CONTENT_TREE_NODE_QUEUE_CAPACITY;
+  nodes = (dom_tree_node_t **)mem_grow(NULL, cap * sizeof(*nodes));
+  parents = (uint64_t *)mem_grow(NULL, cap * sizeof(*parents));
+  que = (uint64_t *)mem_grow(NULL, quecap * sizeof(*que));
 
-  tree->root = content_tree_node_new(self->root->body, strlen(self->root->body), CONTENT_TREE_NODE_CAPACITY);
-  content_tree_que = content_tree_node_queue_enqueue(content_tree_que, tree->root);
+  // NOTE: First lay out, in breadth first order, every body to compile
+  //       and the body whose subtree it hangs from, zero standing for
+  //       the root. A child without a body hands its children to the
+  //       nearest ancestor that has one, so it queues that ancestor.
+  trav = dom_trav_new(DOM_TRAV_BFS);
+  dom_trav_reset(trav, self->root);
 
-  while (NULL != (node = dom_tree_node_queue_dequeue(que)))
+  count = r = w = 0ul;
+  que[w++] = 0ul;
+
+  while (NULL != (node = dom_trav_next(trav)))
   {
-    parent = content_tree_node_queue_dequeue(content_tree_que);
+    p = que[r++];
 
     for (i = 0ul; i < node->count; i++)
     {
@@ -52,34 +108,68 @@ content_tree_t *dom_tree_expand(dom_tree_t *self)
         continue;
       }
 
-      que = dom_tree_node_queue_enqueue(que, node->children[i]);
+      if (w >= quecap)
+      {
+        quecap <<= 1;
+        que = (uint64_t *)mem_grow(que, quecap * sizeof(*que));
+      }
 
       if (NULL == node->children[i]->body)
       {
+        que[w++] = p;
         continue;
       }
 
-      subtree = text_compile(node->children[i]->body);
-
-      if (parent != NULL)
+      if (count >= cap)
       {
-        if (false == content_tree_node_append(parent, subtree->root))
-        {
-          fprintf(stderr, "%s(): %s\n", __func__, "could not append content tree node child to parent");
-          exit(EXIT_FAILURE);
-        }
+        cap <<= 1;
+        nodes = (dom_tree_node_t **)mem_grow(nodes, cap * sizeof(*nodes));
+        parents = (uint64_t *)mem_grow(parents, cap * sizeof(*parents));
       }
 
-      content_tree_que = content_tree_node_queue_enqueue(content_tree_que, subtree->root);
+      nodes[count] = node->children[i];
+      parents[count] = p;
+      que[w++] = ++count;
+    }
+  }
+
+  dom_trav_destroy(trav);
+  free(que);
+
+  // NOTE: Then compile runs of bodies on up to 'nthreads' threads. A
+  //       compile keeps its token queues and nodes to itself, so the
+  //       workers share nothing but the slots they fill in ...
+  roots = (content_tree_node_t **)mem_grow(NULL, (count + 1ul) * sizeof(*roots));
+  ntasks = (count + DOM_TREE_EXPAND_CHUNK - 1ul) / DOM_TREE_EXPAND_CHUNK;
+  tasks = (dom_tree_expand_task_t *)mem_grow(NULL, (ntasks + 1ul) * sizeof(*tasks));
 
-      subtree->root = NULL;
-      content_tree_destroy(subtree);
-      subtree = NULL;
+  for (i = 0ul; i < ntasks; i++)
+  {
+    tasks[i].nodes = nodes;
+    tasks[i].roots = roots;
+    tasks[i].begin = i * DOM_TREE_EXPAND_CHUNK;
+    tasks[i].end = (count < (i + 1ul) * DOM_TREE_EXPAND_CHUNK) ? count : ((i + 1ul) * DOM_TREE_EXPAND_CHUNK);
+  }
+
+  task_run(&dom_tree_expand_compile, tasks, sizeof(*tasks), ntasks, nthreads);
+
+  // NOTE: ... and attach the subtrees in the order a sequential walk
+  //       would have, so the result never depends on the scheduling.
+  for (i = 0ul; i < count; i++)
+  {
+    parent = (0ul == parents[i]) ? tree->root : roots[parents[i] - 1ul];
+
+    if (false == content_tree_node_append(parent, roots[i]))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not append content tree node child to parent");
+      exit(EXIT_FAILURE);
     }
   }
 
-  dom_tree_node_queue_destroy(que);
-  content_tree_node_queue_destroy(content_tree_que);
+  free(tasks);
+  free(roots);
+  free(parents);
+  free(nodes);
   return tree;
 }
 
@@ -93,7 +183,7 @@ int main(int argc, const char *argv[])
   // content_tree_t *content_tree = NULL;
   dom_tree_t *dom_tree = NULL;
   dom_tree = html_parse_file(argv[1]);
-  // content_tree = dom_tree_expand(dom_tree);
+  // content_tree = dom_tree_expand(dom_tree, 0ul);
   dom_tree_print(dom_tree);
   // content_tree_print(content_tree);
   dom_tree_destroy(dom_tree);
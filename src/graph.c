@@ -11,6 +11,8 @@
  * Licensed under the Academic Free License version 3.0.
  */
 #include "graph.h"
+#include "mem.h"
+#include "task.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -19,194 +21,1044 @@
 #include <stdlib.h>
 #include <string.h>
 
-struct queue
-{
-  size_t cap;
-  uint64_t r;
-  uint64_t w;
-  int items[1u << 5];
-};
-
-typedef struct queue queue_t;
+#define GRAPH_BITS_WORDS(n) (((n) + 63ul) >> 6)
+#define GRAPH_BIT_TEST(b, i) (0ul != ((b)[(i) >> 6] & (1ul << ((i) & 63ul))))
+#define GRAPH_BIT_SET(b, i)  ((b)[(i) >> 6] |= (1ul << ((i) & 63ul)))
 
-void queue_setup(queue_t *self)
+static uint64_t graph_hash(const void *data, const size_t size)
 {
-  memset(self, 0, sizeof(*self));
-  self->cap = 1ul << 5;
-}
+  const uint8_t *p = (const uint8_t *)data;
+  uint64_t hash = 0xcbf29ce484222325ul;
+  size_t i;
 
-bool queue_enqueue(queue_t *self, const int item)
-{
-  if ((self->w - self->r) >= self->cap)
+  for (i = 0ul; i < size; i++)
   {
-    return false;
+    hash ^= p[i];
+    hash *= 0x100000001b3ul;
   }
-  self->items[self->w++ % self->cap] = item;
-  return true;
+
+  return hash;
 }
 
-int *queue_dequeue(queue_t *self)
+static void graph_builder_setup(graph_builder_t *self)
 {
-  if (self->r == self->w)
+  self->cap = GRAPH_VERTICES_CAPACITY;
+  self->count = 0ul;
+  self->labels = (uint64_t *)mem_grow(NULL, self->cap * sizeof(*self->labels));
+
+  self->edgecap = GRAPH_EDGES_CAPACITY;
+  self->nedges = 0ul;
+  self->edges = (graph_edge_t *)mem_grow(NULL, self->edgecap * sizeof(*self->edges));
+
+  self->slotcap = GRAPH_LABELS_CAPACITY;
+  self->nslots = 0ul;
+  self->slots = (graph_label_t *)calloc(self->slotcap, sizeof(*self->slots));
+  if (self->slots == NULL)
   {
-    return NULL;
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
   }
-  return (self->items + (self->r++ % self->cap));
+
+  self->strcap = GRAPH_STRINGS_CAPACITY;
+  self->strsize = 0ul;
+  self->strings = (char *)mem_grow(NULL, self->strcap * sizeof(*self->strings));
 }
 
-static graph_node_t *graph_node_new(const char *name)
+graph_builder_t *graph_builder_new(void)
 {
-  graph_node_t *self = NULL;
-  self = (graph_node_t *)calloc(1ul, sizeof(*self));
-  strcpy(self->name, name);
+  graph_builder_t *self = NULL;
+  self = (graph_builder_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  graph_builder_setup(self);
   return self;
 }
 
-static void __attribute__ ((unused)) graph_node_destroy(graph_node_t *self)
+void graph_builder_destroy(graph_builder_t *self)
 {
   if (self != NULL)
   {
+    free(self->labels);
+    free(self->edges);
+    free(self->slots);
+    free(self->strings);
     free(self);
     self = NULL;
   }
 }
 
-static void graph_node_queue_setup(graph_node_queue_t *self, const size_t size, const size_t cap)
+/**
+ * @brief Return the slot holding the label, or the empty slot where it
+ *        belongs. The capacity is a power of two.
+ */
+static graph_label_t *graph_builder_slot(const graph_builder_t *self, const uint64_t hash, const char *name, const size_t size)
 {
-  memset(self, 0, size);
-  self->cap = cap;
+  graph_label_t *slot = NULL;
+  uint64_t i;
+
+  for (i = hash & (self->slotcap - 1ul);; i = (i + 1ul) & (self->slotcap - 1ul))
+  {
+    slot = self->slots + i;
+    if (slot->len == 0ul && slot->hash == 0ul)
+    {
+      return slot;
+    }
+    if (slot->hash == hash && slot->len == size && 0 == memcmp(self->strings + slot->offset, name, size))
+    {
+      return slot;
+    }
+  }
 }
 
-graph_node_queue_t *graph_node_queue_new(const size_t cap)
+static void graph_builder_rehash(graph_builder_t *self)
 {
-  const size_t size = offsetof(graph_node_queue_t, nodes[cap]);
-  graph_node_queue_t *self = NULL;
-  self = (graph_node_queue_t *)malloc(size);
-  if (self == NULL)
+  graph_label_t *old = self->slots;
+  const size_t oldcap = self->slotcap;
+  graph_label_t *slot = NULL;
+  uint64_t i;
+
+  self->slotcap <<= 1;
+  self->slots = (graph_label_t *)calloc(self->slotcap, sizeof(*self->slots));
+  if (self->slots == NULL)
   {
     fprintf(stderr, "%s(): %s\n", __func__, "memory error");
     exit(EXIT_FAILURE);
   }
-  graph_node_queue_setup(self, size, cap);
-  return self;
+
+  for (i = 0ul; i < oldcap; i++)
+  {
+    if (old[i].len == 0ul && old[i].hash == 0ul)
+    {
+      continue;
+    }
+    slot = graph_builder_slot(self, old[i].hash, self->strings + old[i].offset, old[i].len);
+    *slot = old[i];
+  }
+
+  free(old);
 }
 
-void graph_node_queue_destroy(graph_node_queue_t *self)
+/**
+ * @brief Find or store the label. New labels get no vertex yet.
+ */
+static graph_label_t *graph_builder_label(graph_builder_t *self, const char *name, const size_t size)
 {
-  if (self == NULL)
+  uint64_t hash = graph_hash(name, size);
+  graph_label_t *slot = NULL;
+
+  // NOTE: An empty label hashes to the offset basis, never zero, so a
+  //       zeroed slot always means an empty one.
+  slot = graph_builder_slot(self, hash, name, size);
+  if (slot->len != 0ul || slot->hash != 0ul)
   {
-    free(self);
-    self = NULL;
+    return slot;
+  }
+
+  if (((self->nslots + 1ul) << 1) > self->slotcap)
+  {
+    graph_builder_rehash(self);
+    slot = graph_builder_slot(self, hash, name, size);
   }
+
+  if ((self->strsize + size + 1ul) > self->strcap)
+  {
+    while ((self->strsize + size + 1ul) > self->strcap)
+    {
+      self->strcap <<= 1;
+    }
+    self->strings = (char *)mem_grow(self->strings, self->strcap * sizeof(*self->strings));
+  }
+
+  memcpy(self->strings + self->strsize, name, size);
+  self->strings[self->strsize + size] = '\0';
+
+  slot->hash = hash;
+  slot->offset = self->strsize;
+  slot->len = (uint32_t)size;
+  slot->vertex = UINT32_MAX;
+
+  self->strsize += size + 1ul;
+  self->nslots++;
+  return slot;
 }
 
-bool graph_node_queue_enqueue(graph_node_queue_t *self, graph_node_t *node)
+uint32_t graph_builder_add_vertex(graph_builder_t *self, const char *name, const size_t size)
 {
-  if ((self->w - self->r) >= self->cap)
+  graph_label_t *slot = graph_builder_label(self, name, size);
+
+  if (self->count >= UINT32_MAX)
   {
-    return false;
+    fprintf(stderr, "%s(): %s\n", __func__, "too many vertices");
+    exit(EXIT_FAILURE);
   }
-  self->nodes[self->w++ % self->cap] = node;
-  return true;
+
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->labels = (uint64_t *)mem_grow(self->labels, self->cap * sizeof(*self->labels));
+  }
+
+  if (slot->vertex == UINT32_MAX)
+  {
+    slot->vertex = (uint32_t)self->count;
+  }
+
+  self->labels[self->count] = slot->offset;
+  return (uint32_t)self->count++;
 }
 
-graph_node_t *graph_node_queue_dequeue(graph_node_queue_t *self)
+uint32_t graph_builder_intern(graph_builder_t *self, const char *name, const size_t size)
 {
-  if (self->r == self->w)
+  graph_label_t *slot = graph_builder_label(self, name, size);
+
+  if (slot->vertex != UINT32_MAX)
   {
-    return NULL;
+    return slot->vertex;
   }
-  return self->nodes[self->r++ % self->cap];
+
+  return graph_builder_add_vertex(self, name, size);
 }
 
-static void graph_setup(graph_t *self, const size_t size, const size_t cap)
+void graph_builder_add_edge(graph_builder_t *self, const uint32_t src, const uint32_t dst, const int32_t weight)
 {
-  memset(self, 0, size);
-  self->cap = cap;
+  if (self->nedges >= self->edgecap)
+  {
+    self->edgecap <<= 1;
+    self->edges = (graph_edge_t *)mem_grow(self->edges, self->edgecap * sizeof(*self->edges));
+  }
+
+  self->edges[self->nedges].src = src;
+  self->edges[self->nedges].dst = dst;
+  self->edges[self->nedges].weight = weight;
+  self->nedges++;
 }
 
-graph_t *graph_new(const size_t cap)
+graph_t *graph_new(const uint64_t count, const graph_edge_t *edges, const uint64_t nedges)
 {
-  const size_t size = offsetof(graph_t, adj_list[cap]);
   graph_t *self = NULL;
-  self = (graph_t *)malloc(size);
+  uint64_t *next = NULL;
+  uint64_t i;
+
+  self = (graph_t *)calloc(1ul, sizeof(*self));
   if (self == NULL)
   {
     fprintf(stderr, "%s(): %s\n", __func__, "memory error");
     exit(EXIT_FAILURE);
   }
-  graph_setup(self, size, cap);
+
+  self->count = count;
+  self->nedges = nedges;
+  self->offsets = (uint64_t *)calloc(count + 1ul, sizeof(*self->offsets));
+  self->targets = (uint32_t *)mem_grow(NULL, nedges * sizeof(*self->targets));
+  self->weights = (int32_t *)mem_grow(NULL, nedges * sizeof(*self->weights));
+  if (self->offsets == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  // NOTE: Count the out degrees, turn them into offsets, then place
+  //       each edge at the next free slot of its source. Edges out of
+  //       one vertex keep the order they came in.
+  for (i = 0ul; i < nedges; i++)
+  {
+    if (edges[i].src >= count || edges[i].dst >= count)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "edge vertex out of range");
+      exit(EXIT_FAILURE);
+    }
+    self->offsets[edges[i].src + 1ul]++;
+  }
+
+  for (i = 0ul; i < count; i++)
+  {
+    self->offsets[i + 1ul] += self->offsets[i];
+  }
+
+  next = (uint64_t *)mem_grow(NULL, (count + 1ul) * sizeof(*next));
+  memcpy(next, self->offsets, (count + 1ul) * sizeof(*next));
+
+  for (i = 0ul; i < nedges; i++)
+  {
+    self->targets[next[edges[i].src]] = edges[i].dst;
+    self->weights[next[edges[i].src]] = edges[i].weight;
+    next[edges[i].src]++;
+  }
+
+  free(next);
   return self;
 }
 
+graph_t *graph_builder_finish(graph_builder_t *self)
+{
+  graph_t *graph = NULL;
+
+  graph = graph_new(self->count, self->edges, self->nedges);
+  graph->labels = self->labels;
+  graph->strsize = self->strsize;
+  graph->strings = self->strings;
+
+  free(self->edges);
+  free(self->slots);
+  graph_builder_setup(self);
+  return graph;
+}
+
 void graph_destroy(graph_t *self)
 {
   if (self != NULL)
   {
+    free(self->offsets);
+    free(self->targets);
+    free(self->weights);
+    free(self->labels);
+    free(self->strings);
     free(self);
     self = NULL;
   }
 }
 
-static void graph_add_node(graph_t *self, graph_node_t *node)
+uint64_t graph_degree(const graph_t *self, const uint32_t vertex)
 {
-  node->vertex = self->count++;
-  self->vertices[node->vertex] = node;
+  return self->offsets[vertex + 1ul] - self->offsets[vertex];
 }
 
-void graph_add_directed_edge(graph_t *self, graph_node_t *dst, graph_node_t *src, const int weight)
+const char *graph_label(const graph_t *self, const uint32_t vertex, size_t *len)
 {
-  // dst->next = self->adj_list[src->vertex];
-  // self->adj_list[src->vertex] = dst;
-  src->weight = weight;
-  src->next = self->adj_list[dst->vertex];
-  self->adj_list[dst->vertex] = src;
+  const char *label = "";
+
+  if (self->labels != NULL)
+  {
+    label = self->strings + self->labels[vertex];
+  }
+
+  if (len != NULL)
+  {
+    *len = strlen(label);
+  }
+
+  return label;
+}
+
+graph_t *graph_transpose(const graph_t *self)
+{
+  graph_t *graph = NULL;
+  uint64_t *next = NULL;
+  uint64_t e;
+  uint64_t v;
+  uint32_t t;
+
+  graph = (graph_t *)calloc(1ul, sizeof(*graph));
+  if (graph == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  graph->count = self->count;
+  graph->nedges = self->nedges;
+  graph->offsets = (uint64_t *)calloc(self->count + 1ul, sizeof(*graph->offsets));
+  graph->targets = (uint32_t *)mem_grow(NULL, self->nedges * sizeof(*graph->targets));
+  graph->weights = (int32_t *)mem_grow(NULL, self->nedges * sizeof(*graph->weights));
+  if (graph->offsets == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (e = 0ul; e < self->nedges; e++)
+  {
+    graph->offsets[self->targets[e] + 1ul]++;
+  }
+
+  for (v = 0ul; v < self->count; v++)
+  {
+    graph->offsets[v + 1ul] += graph->offsets[v];
+  }
+
+  next = (uint64_t *)mem_grow(NULL, (self->count + 1ul) * sizeof(*next));
+  memcpy(next, graph->offsets, (self->count + 1ul) * sizeof(*next));
+
+  for (v = 0ul; v < self->count; v++)
+  {
+    for (e = self->offsets[v]; e < self->offsets[v + 1ul]; e++)
+    {
+      t = self->targets[e];
+      graph->targets[next[t]] = (uint32_t)v;
+      graph->weights[next[t]] = self->weights[e];
+      next[t]++;
+    }
+  }
+
+  free(next);
+
+  if (self->labels != NULL)
+  {
+    graph->labels = (uint64_t *)mem_grow(NULL, self->count * sizeof(*graph->labels));
+    memcpy(graph->labels, self->labels, self->count * sizeof(*graph->labels));
+    graph->strsize = self->strsize;
+    graph->strings = (char *)mem_grow(NULL, self->strsize * sizeof(*graph->strings));
+    memcpy(graph->strings, self->strings, self->strsize * sizeof(*graph->strings));
+  }
+
+  return graph;
 }
 
-graph_node_t *graph_node_create(graph_t *self, const char *name)
+/**
+ * @brief The state shared by the steps of one search. The frontier is
+ *        either the queue or the 'front' bitset, depending on which way
+ *        the current step runs.
+ */
+struct graph_bfs
+{
+  const graph_t *out;
+  const graph_t *in;
+  int32_t *depth;
+  int32_t level;
+  uint64_t *visited;
+  uint64_t *front;
+  uint64_t *next;
+  uint32_t *queue;
+  uint64_t nqueue;
+  bool shared;
+};
+
+typedef struct graph_bfs graph_bfs_t;
+
+/**
+ * @brief One task of a step: a range of the frontier queue top-down, or
+ *        of the vertices bottom-up. 'found' collects what a top-down
+ *        task discovers, 'nf' and 'mf' count the vertices and the out
+ *        edges of the next frontier.
+ */
+struct graph_bfs_task
+{
+  graph_bfs_t *bfs;
+  uint64_t begin;
+  uint64_t end;
+  size_t cap;
+  uint64_t count;
+  uint32_t *found;
+  uint64_t nf;
+  uint64_t mf;
+};
+
+typedef struct graph_bfs_task graph_bfs_task_t;
+
+static void graph_bfs_top_down(void *arg)
 {
-  graph_node_t *node = graph_node_new(name);
-  graph_add_node(self, node);
-  return node;
+  graph_bfs_task_t *self = (graph_bfs_task_t *)arg;
+  graph_bfs_t *bfs = self->bfs;
+  const uint64_t *offsets = bfs->out->offsets;
+  const uint32_t *targets = bfs->out->targets;
+  uint64_t *visited = bfs->visited;
+  int32_t *depth = bfs->depth;
+  const int32_t level = bfs->level + 1;
+  uint64_t count = 0ul;
+  uint64_t mf = 0ul;
+  uint64_t bit;
+  uint64_t old;
+  uint64_t end;
+  uint64_t i;
+  uint64_t e;
+  uint32_t t;
+
+  for (i = self->begin; i < self->end; i++)
+  {
+    end = offsets[bfs->queue[i] + 1ul];
+
+    for (e = offsets[bfs->queue[i]]; e < end; e++)
+    {
+      t = targets[e];
+      bit = 1ul << (t & 63ul);
+
+      if (0ul != (__atomic_load_n(visited + (t >> 6), __ATOMIC_RELAXED) & bit))
+      {
+        continue;
+      }
+
+      // NOTE: Only the task that flips the bit claims the vertex. A
+      //       step run by one thread has nobody to race with.
+      if (bfs->shared)
+      {
+        old = __atomic_fetch_or(visited + (t >> 6), bit, __ATOMIC_RELAXED);
+        if (0ul != (old & bit))
+        {
+          continue;
+        }
+      }
+      else
+      {
+        visited[t >> 6] |= bit;
+      }
+
+      depth[t] = level;
+
+      if (count >= self->cap)
+      {
+        self->cap = (self->cap == 0ul) ? GRAPH_BFS_CHUNK : (self->cap << 1);
+        self->found = (uint32_t *)mem_grow(self->found, self->cap * sizeof(*self->found));
+      }
+
+      self->found[count++] = t;
+
+      // NOTE: The edge count only decides when to go bottom-up.
+      if (bfs->in != NULL)
+      {
+        mf += offsets[t + 1ul] - offsets[t];
+      }
+    }
+  }
+
+  self->count = self->nf = count;
+  self->mf = mf;
 }
 
-void graph_BFS(graph_t *self, const int start)
+static void graph_bfs_bottom_up(void *arg)
 {
-  queue_t que;
-  graph_node_t *node = NULL;
-  int *item = NULL;
+  graph_bfs_task_t *self = (graph_bfs_task_t *)arg;
+  graph_bfs_t *bfs = self->bfs;
+  const uint64_t *offsets = bfs->in->offsets;
+  const uint32_t *targets = bfs->in->targets;
+  const uint64_t *degrees = bfs->out->offsets;
+  const uint64_t *visited = bfs->visited;
+  const uint64_t *front = bfs->front;
+  uint64_t *next = bfs->next;
+  const int32_t level = bfs->level + 1;
+  uint64_t nf = 0ul;
+  uint64_t mf = 0ul;
+  uint64_t end;
+  uint64_t v;
+  uint64_t e;
 
-  queue_setup(&que);
+  // NOTE: Task ranges are whole words of the bitsets, so no other task
+  //       writes the words of 'next' this one does.
+  for (v = self->begin; v < self->end; v++)
+  {
+    if (GRAPH_BIT_TEST(visited, v))
+    {
+      continue;
+    }
 
-  self->visited[start] = 1;
-  if (false == queue_enqueue(&que, start))
+    end = offsets[v + 1ul];
+
+    for (e = offsets[v]; e < end; e++)
+    {
+      if (GRAPH_BIT_TEST(front, targets[e]))
+      {
+        bfs->depth[v] = level;
+        GRAPH_BIT_SET(next, v);
+        nf++;
+        mf += degrees[v + 1ul] - degrees[v];
+        break;
+      }
+    }
+  }
+
+  self->nf = nf;
+  self->mf = mf;
+}
+
+/**
+ * @brief Split 'n' entries into tasks of GRAPH_BFS_CHUNK, run them and
+ *        return the number of tasks.
+ */
+static uint64_t graph_bfs_run(graph_bfs_task_t **tasks, uint64_t *ntasks, graph_bfs_t *bfs, const uint64_t n, const uint64_t nthreads, task_func_t call)
+{
+  const uint64_t count = (n + GRAPH_BFS_CHUNK - 1ul) / GRAPH_BFS_CHUNK;
+  uint64_t i;
+
+  if (count > *ntasks)
   {
-    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue item into queue");
+    *tasks = (graph_bfs_task_t *)mem_grow(*tasks, count * sizeof(**tasks));
+    memset(*tasks + *ntasks, 0, (count - *ntasks) * sizeof(**tasks));
+    *ntasks = count;
+  }
+
+  for (i = 0ul; i < count; i++)
+  {
+    (*tasks)[i].bfs = bfs;
+    (*tasks)[i].begin = i * GRAPH_BFS_CHUNK;
+    (*tasks)[i].end = (n < (i + 1ul) * GRAPH_BFS_CHUNK) ? n : ((i + 1ul) * GRAPH_BFS_CHUNK);
+  }
+
+  bfs->shared = (1ul < count && 1ul != nthreads);
+  task_run(call, *tasks, sizeof(**tasks), count, nthreads);
+  return count;
+}
+
+int32_t *graph_bfs(const graph_t *self, const graph_t *in, const uint32_t start, const uint64_t nthreads)
+{
+  const uint64_t words = GRAPH_BITS_WORDS(self->count);
+  graph_bfs_task_t *tasks = NULL;
+  uint64_t *swap = NULL;
+  uint64_t ntasks = 0ul;
+  uint64_t count;
+  uint64_t nf;
+  uint64_t mf;
+  uint64_t mu;
+  uint64_t i;
+  uint64_t v;
+  bool top_down = true;
+  graph_bfs_t bfs;
+
+  bfs.out = self;
+  bfs.in = in;
+  bfs.level = 0;
+  bfs.depth = (int32_t *)mem_grow(NULL, (self->count + 1ul) * sizeof(*bfs.depth));
+  memset(bfs.depth, 0xff, self->count * sizeof(*bfs.depth));
+
+  if (start >= self->count)
+  {
+    return bfs.depth;
+  }
+
+  bfs.visited = (uint64_t *)calloc(words + 1ul, sizeof(*bfs.visited));
+  bfs.front = (uint64_t *)calloc(words + 1ul, sizeof(*bfs.front));
+  bfs.next = (uint64_t *)calloc(words + 1ul, sizeof(*bfs.next));
+  bfs.queue = (uint32_t *)mem_grow(NULL, self->count * sizeof(*bfs.queue));
+  if (bfs.visited == NULL || bfs.front == NULL || bfs.next == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
     exit(EXIT_FAILURE);
   }
 
-  while (NULL != (item = queue_dequeue(&que)))
+  bfs.depth[start] = 0;
+  GRAPH_BIT_SET(bfs.visited, start);
+  bfs.queue[0] = start;
+  bfs.nqueue = 1ul;
+
+  nf = 1ul;
+  mf = graph_degree(self, start);
+  mu = self->nedges - mf;
+
+  while (0ul < nf)
   {
-    printf("(%d)%s ", self->vertices[*item]->weight, self->vertices[*item]->name);
+    // NOTE: Switch representation along with direction: the queue
+    //       becomes a bitset, or the bitset is scanned into the queue.
+    if (top_down && in != NULL && mf > mu / GRAPH_BFS_ALPHA)
+    {
+      memset(bfs.front, 0, words * sizeof(*bfs.front));
+      for (i = 0ul; i < bfs.nqueue; i++)
+      {
+        GRAPH_BIT_SET(bfs.front, bfs.queue[i]);
+      }
+      top_down = false;
+    }
+    else if (!top_down && nf < self->count / GRAPH_BFS_BETA)
+    {
+      bfs.nqueue = 0ul;
+      for (v = 0ul; v < self->count; v++)
+      {
+        if (GRAPH_BIT_TEST(bfs.front, v))
+        {
+          bfs.queue[bfs.nqueue++] = (uint32_t)v;
+        }
+      }
+      top_down = true;
+    }
 
-    node = self->adj_list[*item];
+    nf = mf = 0ul;
 
-    while (node != NULL)
+    if (top_down)
+    {
+      count = graph_bfs_run(&tasks, &ntasks, &bfs, bfs.nqueue, nthreads, &graph_bfs_top_down);
+
+      bfs.nqueue = 0ul;
+      for (i = 0ul; i < count; i++)
+      {
+        // NOTE: A task only allocates 'found' once it finds a vertex.
+        if (0ul == tasks[i].count)
+        {
+          continue;
+        }
+        memcpy(bfs.queue + bfs.nqueue, tasks[i].found, tasks[i].count * sizeof(*bfs.queue));
+        bfs.nqueue += tasks[i].count;
+      }
+    }
+    else
     {
-      if (0 == self->visited[node->vertex])
+      memset(bfs.next, 0, words * sizeof(*bfs.next));
+      count = graph_bfs_run(&tasks, &ntasks, &bfs, self->count, nthreads, &graph_bfs_bottom_up);
+
+      for (i = 0ul; i < words; i++)
       {
-        self->visited[node->vertex] = 1;
+        bfs.visited[i] |= bfs.next[i];
+      }
+
+      swap = bfs.front;
+      bfs.front = bfs.next;
+      bfs.next = swap;
+    }
+
+    for (i = 0ul; i < count; i++)
+    {
+      nf += tasks[i].nf;
+      mf += tasks[i].mf;
+    }
+
+    mu = (mf < mu) ? (mu - mf) : 0ul;
+    bfs.level++;
+  }
+
+  for (i = 0ul; i < ntasks; i++)
+  {
+    free(tasks[i].found);
+  }
+
+  free(tasks);
+  free(bfs.visited);
+  free(bfs.front);
+  free(bfs.next);
+  free(bfs.queue);
+  return bfs.depth;
+}
+
+struct graph_rank
+{
+  const graph_t *out;
+  const graph_t *in;
+  double base;
+  double damping;
+  double *rank;
+  double *next;
+  double *contrib;
+};
+
+typedef struct graph_rank graph_rank_t;
+
+/**
+ * @brief One task of a PageRank pass over a range of vertices. 'sum'
+ *        collects the rank of vertices without out edges, 'delta' how
+ *        far the ranks moved.
+ */
+struct graph_rank_task
+{
+  graph_rank_t *pr;
+  uint64_t begin;
+  uint64_t end;
+  double sum;
+  double delta;
+};
+
+typedef struct graph_rank_task graph_rank_task_t;
+
+static void graph_rank_scatter(void *arg)
+{
+  graph_rank_task_t *self = (graph_rank_task_t *)arg;
+  graph_rank_t *pr = self->pr;
+  const uint64_t *offsets = pr->out->offsets;
+  uint64_t degree;
+  uint64_t v;
+
+  self->sum = 0.0;
+
+  for (v = self->begin; v < self->end; v++)
+  {
+    degree = offsets[v + 1ul] - offsets[v];
+    if (0ul == degree)
+    {
+      self->sum += pr->rank[v];
+      pr->contrib[v] = 0.0;
+      continue;
+    }
+    pr->contrib[v] = pr->rank[v] / (double)degree;
+  }
+}
+
+static void graph_rank_gather(void *arg)
+{
+  graph_rank_task_t *self = (graph_rank_task_t *)arg;
+  graph_rank_t *pr = self->pr;
+  const uint64_t *offsets = pr->in->offsets;
+  const uint32_t *targets = pr->in->targets;
+  const double *contrib = pr->contrib;
+  double sum;
+  uint64_t end;
+  uint64_t v;
+  uint64_t e;
+
+  self->delta = 0.0;
+
+  for (v = self->begin; v < self->end; v++)
+  {
+    sum = 0.0;
+    end = offsets[v + 1ul];
+
+    for (e = offsets[v]; e < end; e++)
+    {
+      sum += contrib[targets[e]];
+    }
+
+    pr->next[v] = pr->base + pr->damping * sum;
+    self->delta += (pr->next[v] > pr->rank[v]) ? (pr->next[v] - pr->rank[v]) : (pr->rank[v] - pr->next[v]);
+  }
+}
+
+static void *graph_tasks(const uint64_t n, const size_t size, uint64_t *count)
+{
+  void *tasks = NULL;
+
+  *count = (n + GRAPH_TASK_CHUNK - 1ul) / GRAPH_TASK_CHUNK;
+  tasks = calloc((*count == 0ul) ? 1ul : *count, size);
+  if (tasks == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return tasks;
+}
+
+double *graph_pagerank(const graph_t *self, const graph_t *in, const double damping, const uint64_t iterations, const double epsilon, const uint64_t nthreads)
+{
+  graph_rank_task_t *tasks = NULL;
+  double *swap = NULL;
+  graph_rank_t pr;
+  double dangling;
+  double delta;
+  uint64_t count;
+  uint64_t i;
+  uint64_t k;
+
+  pr.out = self;
+  pr.in = in;
+  pr.damping = damping;
+  pr.rank = (double *)mem_grow(NULL, (self->count + 1ul) * sizeof(*pr.rank));
+  pr.next = (double *)mem_grow(NULL, (self->count + 1ul) * sizeof(*pr.next));
+  pr.contrib = (double *)mem_grow(NULL, (self->count + 1ul) * sizeof(*pr.contrib));
+
+  for (i = 0ul; i < self->count; i++)
+  {
+    pr.rank[i] = 1.0 / (double)self->count;
+  }
 
-        if (false == queue_enqueue(&que, node->vertex))
+  tasks = (graph_rank_task_t *)graph_tasks(self->count, sizeof(*tasks), &count);
+  for (i = 0ul; i < count; i++)
+  {
+    tasks[i].pr = &pr;
+    tasks[i].begin = i * GRAPH_TASK_CHUNK;
+    tasks[i].end = (self->count < (i + 1ul) * GRAPH_TASK_CHUNK) ? self->count : ((i + 1ul) * GRAPH_TASK_CHUNK);
+  }
+
+  for (k = 0ul; k < iterations && 0ul < self->count; k++)
+  {
+    task_run(&graph_rank_scatter, tasks, sizeof(*tasks), count, nthreads);
+
+    dangling = 0.0;
+    for (i = 0ul; i < count; i++)
+    {
+      dangling += tasks[i].sum;
+    }
+
+    pr.base = (1.0 - damping + damping * dangling) / (double)self->count;
+    task_run(&graph_rank_gather, tasks, sizeof(*tasks), count, nthreads);
+
+    delta = 0.0;
+    for (i = 0ul; i < count; i++)
+    {
+      delta += tasks[i].delta;
+    }
+
+    swap = pr.rank;
+    pr.rank = pr.next;
+    pr.next = swap;
+
+    if (delta < epsilon)
+    {
+      break;
+    }
+  }
+
+  free(tasks);
+  free(pr.next);
+  free(pr.contrib);
+  return pr.rank;
+}
+
+struct graph_union_task
+{
+  const graph_t *graph;
+  uint32_t *parent;
+  uint64_t begin;
+  uint64_t end;
+};
+
+typedef struct graph_union_task graph_union_task_t;
+
+/**
+ * @brief Find the root of the vertex, halving the path on the way. The
+ *        shortcuts only ever point higher up the same tree, so they are
+ *        safe to race with.
+ */
+static uint32_t graph_union_find(uint32_t *parent, uint32_t v)
+{
+  uint32_t p;
+  uint32_t g;
+
+  for (;;)
+  {
+    p = __atomic_load_n(parent + v, __ATOMIC_RELAXED);
+    if (p == v)
+    {
+      return v;
+    }
+
+    g = __atomic_load_n(parent + p, __ATOMIC_RELAXED);
+    if (g != p)
+    {
+      __atomic_compare_exchange_n(parent + v, &p, g, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+
+    v = g;
+  }
+}
+
+static void graph_union_edges(void *arg)
+{
+  graph_union_task_t *self = (graph_union_task_t *)arg;
+  const uint64_t *offsets = self->graph->offsets;
+  const uint32_t *targets = self->graph->targets;
+  uint32_t a;
+  uint32_t b;
+  uint32_t t;
+  uint64_t v;
+  uint64_t e;
+
+  for (v = self->begin; v < self->end; v++)
+  {
+    for (e = offsets[v]; e < offsets[v + 1ul]; e++)
+    {
+      a = (uint32_t)v;
+      b = targets[e];
+
+      // NOTE: Always hang the larger root under the smaller one, so
+      //       every root is the smallest vertex of its tree. Losing the
+      //       exchange means another thread moved the root; retry.
+      for (;;)
+      {
+        a = graph_union_find(self->parent, a);
+        b = graph_union_find(self->parent, b);
+        if (a == b)
+        {
+          break;
+        }
+
+        if (a < b)
         {
-          fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue item into queue");
-          exit(EXIT_FAILURE);
+          t = a;
+          a = b;
+          b = t;
+        }
+
+        t = a;
+        if (__atomic_compare_exchange_n(self->parent + a, &t, b, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+          break;
         }
       }
+    }
+  }
+}
+
+static void graph_union_flatten(void *arg)
+{
+  graph_union_task_t *self = (graph_union_task_t *)arg;
+  uint64_t v;
+
+  for (v = self->begin; v < self->end; v++)
+  {
+    self->parent[v] = graph_union_find(self->parent, (uint32_t)v);
+  }
+}
 
-      node = node->next;
+uint32_t *graph_components(const graph_t *self, uint64_t *n, const uint64_t nthreads)
+{
+  graph_union_task_t *tasks = NULL;
+  uint32_t *parent = NULL;
+  uint64_t count;
+  uint64_t i;
+
+  parent = (uint32_t *)mem_grow(NULL, (self->count + 1ul) * sizeof(*parent));
+  for (i = 0ul; i < self->count; i++)
+  {
+    parent[i] = (uint32_t)i;
+  }
+
+  tasks = (graph_union_task_t *)graph_tasks(self->count, sizeof(*tasks), &count);
+  for (i = 0ul; i < count; i++)
+  {
+    tasks[i].graph = self;
+    tasks[i].parent = parent;
+    tasks[i].begin = i * GRAPH_TASK_CHUNK;
+    tasks[i].end = (self->count < (i + 1ul) * GRAPH_TASK_CHUNK) ? self->count : ((i + 1ul) * GRAPH_TASK_CHUNK);
+  }
+
+  task_run(&graph_union_edges, tasks, sizeof(*tasks), count, nthreads);
+  task_run(&graph_union_flatten, tasks, sizeof(*tasks), count, nthreads);
+
+  *n = 0ul;
+  for (i = 0ul; i < self->count; i++)
+  {
+    *n += (parent[i] == (uint32_t)i);
+  }
+
+  free(tasks);
+  return parent;
+}
+
+void graph_BFS(const graph_t *self, const uint32_t start)
+{
+  uint32_t *que = NULL;
+  int32_t *weight = NULL;
+  uint64_t *visited = NULL;
+  uint64_t r;
+  uint64_t w;
+  uint64_t e;
+  uint32_t v;
+
+  if (start >= self->count)
+  {
+    return;
+  }
+
+  // NOTE: Every vertex is queued at most once.
+  que = (uint32_t *)mem_grow(NULL, self->count * sizeof(*que));
+  weight = (int32_t *)mem_grow(NULL, self->count * sizeof(*weight));
+  visited = (uint64_t *)calloc(GRAPH_BITS_WORDS(self->count), sizeof(*visited));
+  if (visited == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  r = w = 0ul;
+  que[w++] = start;
+  weight[start] = 0;
+  GRAPH_BIT_SET(visited, start);
+
+  while (r < w)
+  {
+    v = que[r++];
+    printf("(%d)%s ", weight[v], graph_label(self, v, NULL));
+
+    for (e = self->offsets[v]; e < self->offsets[v + 1ul]; e++)
+    {
+      if (!GRAPH_BIT_TEST(visited, self->targets[e]))
+      {
+        GRAPH_BIT_SET(visited, self->targets[e]);
+        weight[self->targets[e]] = self->weights[e];
+        que[w++] = self->targets[e];
+      }
     }
   }
 
   printf("\n");
+
+  free(que);
+  free(weight);
+  free(visited);
 }
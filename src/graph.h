@@ -4,55 +4,176 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <string.h>
 
-struct graph_node
+#define GRAPH_VERTICES_CAPACITY (1ul << 5)
+#define GRAPH_EDGES_CAPACITY    (1ul << 5)
+#define GRAPH_LABELS_CAPACITY   (1ul << 6)
+#define GRAPH_STRINGS_CAPACITY  (1ul << 10)
+
+/**
+ * @brief Direction switching thresholds of the breadth first search:
+ *        go bottom-up once the frontier's edges exceed 1/ALPHA of the
+ *        unexplored ones, back top-down once the frontier holds fewer
+ *        than 1/BETA of the vertices. CHUNK is the number of frontier
+ *        entries or vertices a task takes on, a multiple of 64.
+ */
+#define GRAPH_BFS_ALPHA 14ul
+#define GRAPH_BFS_BETA  24ul
+#define GRAPH_BFS_CHUNK (1ul << 12)
+
+/**
+ * @brief Vertices per task of the PageRank and component passes.
+ */
+#define GRAPH_TASK_CHUNK (1ul << 12)
+
+#define GRAPH_PAGERANK_DAMPING    0.85
+#define GRAPH_PAGERANK_ITERATIONS 50ul
+#define GRAPH_PAGERANK_EPSILON    1e-9
+
+struct graph_edge
 {
-  char name[32];
-  int weight;
-  int vertex;
-  struct graph_node *next;
+  uint32_t src;
+  uint32_t dst;
+  int32_t weight;
 };
 
-typedef struct graph_node graph_node_t;
+typedef struct graph_edge graph_edge_t;
 
-struct graph_node_queue
+/**
+ * @brief A label slot maps a string to its offset in the label strings
+ *        and to the first vertex given that label.
+ */
+struct graph_label
 {
-  size_t cap;
-  uint64_t r;
-  uint64_t w;
-  graph_node_t *nodes[];
+  uint64_t hash;
+  uint64_t offset;
+  uint32_t len;
+  uint32_t vertex;
 };
 
-typedef struct graph_node_queue graph_node_queue_t;
-
-graph_node_queue_t *graph_node_queue_new(const size_t cap);
+typedef struct graph_label graph_label_t;
 
-void graph_node_queue_destroy(graph_node_queue_t *self);
-
-bool graph_node_queue_enqueue(graph_node_queue_t *self, graph_node_t *node);
+/**
+ * @brief Collects labelled vertices and an edge list in growable arrays.
+ *        Labels are interned, so vertices sharing a name share its bytes
+ *        and a name can be looked up to its vertex.
+ */
+struct graph_builder
+{
+  size_t cap;
+  uint64_t count;
+  uint64_t *labels;
+  size_t edgecap;
+  uint64_t nedges;
+  graph_edge_t *edges;
+  size_t slotcap;
+  uint64_t nslots;
+  graph_label_t *slots;
+  size_t strcap;
+  uint64_t strsize;
+  char *strings;
+};
 
-graph_node_t *graph_node_queue_dequeue(graph_node_queue_t *self);
+typedef struct graph_builder graph_builder_t;
 
+/**
+ * @brief A directed graph in compressed sparse row form. The edges out
+ *        of vertex v are targets[offsets[v]] up to targets[offsets[v + 1]]
+ *        with their weights alongside. Vertex labels are offsets into
+ *        'strings', or none when the graph was built from bare edges.
+ */
 struct graph
 {
-  size_t cap;
   uint64_t count;
-  int visited[1u << 5];
-  graph_node_t *vertices[1u << 5];
-  graph_node_t *adj_list[];
+  uint64_t nedges;
+  uint64_t *offsets;
+  uint32_t *targets;
+  int32_t *weights;
+  uint64_t *labels;
+  uint64_t strsize;
+  char *strings;
 };
 
 typedef struct graph graph_t;
 
-graph_t *graph_new(const size_t cap);
+graph_builder_t *graph_builder_new(void);
 
-void graph_destroy(graph_t *self);
+void graph_builder_destroy(graph_builder_t *self);
+
+/**
+ * @brief Add a new vertex with the label and return its id.
+ */
+uint32_t graph_builder_add_vertex(graph_builder_t *self, const char *name, const size_t size);
+
+/**
+ * @brief Return the first vertex with the label, adding it when there
+ *        is none.
+ */
+uint32_t graph_builder_intern(graph_builder_t *self, const char *name, const size_t size);
 
-void graph_add_directed_edge(graph_t *self, graph_node_t *dst, graph_node_t *src, const int weight);
+void graph_builder_add_edge(graph_builder_t *self, const uint32_t src, const uint32_t dst, const int32_t weight);
 
-graph_node_t *graph_node_create(graph_t *self, const char *name);
+/**
+ * @brief Lay the edges out by source in one counting pass, keeping the
+ *        order they were added in, and move the labels into the graph.
+ *        The builder is left empty for reuse.
+ */
+graph_t *graph_builder_finish(graph_builder_t *self);
+
+/**
+ * @brief Build an unlabelled graph of 'count' vertices from an edge list.
+ */
+graph_t *graph_new(const uint64_t count, const graph_edge_t *edges, const uint64_t nedges);
+
+void graph_destroy(graph_t *self);
 
-void graph_BFS(graph_t *self, const int start);
+uint64_t graph_degree(const graph_t *self, const uint32_t vertex);
+
+/**
+ * @brief Return the vertex label, or an empty string when it has none.
+ */
+const char *graph_label(const graph_t *self, const uint32_t vertex, size_t *len);
+
+/**
+ * @brief Return the graph with every edge reversed, with the same
+ *        labels.
+ */
+graph_t *graph_transpose(const graph_t *self);
+
+/**
+ * @brief Breadth first search from 'start', returning the depth of
+ *        every vertex, or -1 for those not reached; free() it. Steps run
+ *        top-down from a queue of the frontier while it is small and
+ *        bottom-up while it is large, each unvisited vertex looking for
+ *        a parent in a frontier bitset among its edges in 'in'. 'in' is
+ *        the transpose of the graph, the graph itself when its edges go
+ *        both ways, or NULL to stay top-down. Steps are spread over up
+ *        to 'nthreads' threads, zero meaning one per processor.
+ */
+int32_t *graph_bfs(const graph_t *self, const graph_t *in, const uint32_t start, const uint64_t nthreads);
+
+/**
+ * @brief PageRank by power iteration, pulling each vertex's rank along
+ *        its edges in 'in', the transpose of the graph. Rank held by
+ *        vertices without out edges is spread over all vertices. Stops
+ *        after 'iterations' rounds or once the ranks move less than
+ *        'epsilon' in total. Returns one rank per vertex, summing to
+ *        one; free() it.
+ */
+double *graph_pagerank(const graph_t *self, const graph_t *in, const double damping, const uint64_t iterations, const double epsilon, const uint64_t nthreads);
+
+/**
+ * @brief Label the weakly connected components, each vertex with the
+ *        smallest vertex of its component, and store their number in
+ *        'n'. Edges are merged into a shared union-find forest from
+ *        several threads. Returns the labels; free() them.
+ */
+uint32_t *graph_components(const graph_t *self, uint64_t *n, const uint64_t nthreads);
+
+/**
+ * @brief Print the vertices reachable from 'start' in breadth first
+ *        order, each with the weight of the edge it was reached by.
+ */
+void graph_BFS(const graph_t *self, const uint32_t start);
 
 #endif/*GRAPH_H*/
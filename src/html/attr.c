@@ -58,20 +58,13 @@ void dom_tree_node_attr_destroy(dom_tree_node_attr_t *self)
 
 bool dom_tree_node_attr_append_value(dom_tree_node_attr_t *self, const void *data, const size_t size)
 {
-  if (self->value == NULL)
-  {
-    self->value = (char *)calloc(DOM_TREE_NODE_ATTR_VALLEN_DEFAULT, sizeof(*self->value));
-  }
-  else
+  const size_t prev_threshold = (self->value == NULL) ? 0ul : (1ul + self->vallen / DOM_TREE_NODE_ATTR_VALLEN_DEFAULT);
+  const size_t curr_threshold = 1ul + (size + self->vallen) / DOM_TREE_NODE_ATTR_VALLEN_DEFAULT;
+  if (curr_threshold > prev_threshold)
   {
-    const size_t prev_threshold = self->vallen / DOM_TREE_NODE_ATTR_VALLEN_DEFAULT;
-    const size_t curr_threshold = (size + self->vallen) / DOM_TREE_NODE_ATTR_VALLEN_DEFAULT;
-    if (curr_threshold > prev_threshold)
-    {
-      void *__old = self->value;
-      self->value = NULL;
-      self->value = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_ATTR_VALLEN_DEFAULT * sizeof(self->value));
-    }
+    void *__old = self->value;
+    self->value = NULL;
+    self->value = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_ATTR_VALLEN_DEFAULT * sizeof(*self->value));
   }
   if (self->value == NULL)
   {
@@ -80,6 +73,7 @@ bool dom_tree_node_attr_append_value(dom_tree_node_attr_t *self, const void *dat
   }
   memcpy((self->value + self->vallen), data, size);
   self->vallen += size;
+  self->value[self->vallen] = '\0';
   return true;
 }
 
@@ -0,0 +1,196 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "attrmap.h"
+#include "node.h"
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t dom_attr_map_hash(const void *data, const size_t size)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  uint64_t hash = 0xcbf29ce484222325ul;
+  size_t i;
+
+  for (i = 0ul; i < size; i++)
+  {
+    hash ^= p[i];
+    hash *= 0x100000001b3ul;
+  }
+
+  return hash;
+}
+
+dom_attr_map_t *dom_attr_map_new(const size_t cap)
+{
+  dom_attr_map_t *self = NULL;
+  self = (dom_attr_map_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = cap;
+  self->slots = (dom_attr_slot_t *)calloc(self->cap, sizeof(*self->slots));
+  if (self->slots == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_attr_map_destroy(dom_attr_map_t *self)
+{
+  uint64_t i;
+
+  if (self != NULL)
+  {
+    for (i = 0ul; i < self->cap; i++)
+    {
+      dom_tree_node_list_destroy(self->slots[i].nodes);
+    }
+
+    free(self->slots);
+    free(self);
+    self = NULL;
+  }
+}
+
+/**
+ * @brief Return the slot holding the key, or the empty slot where it
+ *        belongs. The capacity is a power of two.
+ */
+static dom_attr_slot_t *dom_attr_map_probe(const dom_attr_map_t *self, const uint64_t hash, const char *key, const size_t len)
+{
+  const uint64_t mask = self->cap - 1ul;
+  dom_attr_slot_t *slot = NULL;
+  uint64_t i;
+
+  for (i = hash & mask; NULL != (slot = self->slots + i)->nodes; i = (i + 1ul) & mask)
+  {
+    if (slot->hash == hash && slot->len == len && 0 == memcmp(slot->key, key, len))
+    {
+      break;
+    }
+  }
+
+  return slot;
+}
+
+static void dom_attr_map_grow(dom_attr_map_t *self)
+{
+  dom_attr_slot_t *old = self->slots;
+  const size_t cap = self->cap;
+  dom_attr_slot_t *slot = NULL;
+  uint64_t i;
+
+  self->cap <<= 1;
+  self->slots = (dom_attr_slot_t *)calloc(self->cap, sizeof(*self->slots));
+  if (self->slots == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0ul; i < cap; i++)
+  {
+    if (old[i].nodes != NULL)
+    {
+      slot = dom_attr_map_probe(self, old[i].hash, old[i].key, old[i].len);
+      *slot = old[i];
+    }
+  }
+
+  free(old);
+}
+
+void dom_attr_map_add(dom_attr_map_t *self, const char *key, const size_t len, dom_tree_node_t *node)
+{
+  const uint64_t hash = dom_attr_map_hash(key, len);
+  dom_attr_slot_t *slot = NULL;
+
+  slot = dom_attr_map_probe(self, hash, key, len);
+  if (slot->nodes == NULL)
+  {
+    if (((self->count + 1ul) << 1) > self->cap)
+    {
+      dom_attr_map_grow(self);
+      slot = dom_attr_map_probe(self, hash, key, len);
+    }
+
+    slot->hash = hash;
+    slot->key = key;
+    slot->len = len;
+    slot->nodes = dom_tree_node_list_new(1ul);
+    self->count++;
+  }
+
+  // NOTE: An element repeating a class token is listed once.
+  if (0ul < slot->nodes->count && slot->nodes->nodes[slot->nodes->count - 1ul] == node)
+  {
+    return;
+  }
+
+  slot->nodes = dom_tree_node_list_append(slot->nodes, node);
+}
+
+dom_tree_node_list_t *dom_attr_map_get(const dom_attr_map_t *self, const char *key, const size_t len)
+{
+  return dom_attr_map_probe(self, dom_attr_map_hash(key, len), key, len)->nodes;
+}
+
+void dom_attr_map_index(dom_attr_map_t *ids, dom_attr_map_t *classes, dom_tree_node_t *node, const dom_tree_node_attr_t *attr)
+{
+  const char *end = NULL;
+  const char *p = NULL;
+  const char *q = NULL;
+
+  if (attr->value == NULL)
+  {
+    return;
+  }
+
+  if (0 == strcmp(attr->name, "id"))
+  {
+    dom_attr_map_add(ids, attr->value, attr->vallen, node);
+    return;
+  }
+
+  if (0 != strcmp(attr->name, "class"))
+  {
+    return;
+  }
+
+  for (p = attr->value, end = p + attr->vallen; p < end; p = q)
+  {
+    while (p < end && isspace((unsigned char)*p))
+    {
+      p++;
+    }
+
+    for (q = p; q < end && !isspace((unsigned char)*q); q++);
+
+    if (q > p)
+    {
+      dom_attr_map_add(classes, p, (size_t)(q - p), node);
+    }
+  }
+}
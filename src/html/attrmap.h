@@ -0,0 +1,61 @@
+#ifndef ATTRMAP_H
+#define ATTRMAP_H
+
+#include "attr.h"
+#include "node.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_ATTR_MAP_CAPACITY (1ul << 6)
+
+/**
+ * @brief A slot keys a posting list of elements by a string that lives
+ *        in one of their attribute values.
+ */
+struct dom_attr_slot
+{
+  uint64_t hash;
+  const char *key;
+  size_t len;
+  dom_tree_node_list_t *nodes;
+};
+
+typedef struct dom_attr_slot dom_attr_slot_t;
+
+/**
+ * @brief Open addressing map from an attribute value, or a token of it,
+ *        to the elements carrying it in document order. The table is
+ *        kept at most half full.
+ */
+struct dom_attr_map
+{
+  size_t cap;
+  uint64_t count;
+  dom_attr_slot_t *slots;
+};
+
+typedef struct dom_attr_map dom_attr_map_t;
+
+dom_attr_map_t *dom_attr_map_new(const size_t cap);
+
+void dom_attr_map_destroy(dom_attr_map_t *self);
+
+/**
+ * @brief Append the node to the list of the key. The key is not copied
+ *        and must live as long as the map.
+ */
+void dom_attr_map_add(dom_attr_map_t *self, const char *key, const size_t len, dom_tree_node_t *node);
+
+/**
+ * @brief Return the list of the key, or NULL when no element has it.
+ */
+dom_tree_node_list_t *dom_attr_map_get(const dom_attr_map_t *self, const char *key, const size_t len);
+
+/**
+ * @brief Index a finalized attribute of the node: an "id" under its
+ *        value, a "class" under each whitespace separated token.
+ */
+void dom_attr_map_index(dom_attr_map_t *ids, dom_attr_map_t *classes, dom_tree_node_t *node, const dom_tree_node_attr_t *attr);
+
+#endif/*ATTRMAP_H*/
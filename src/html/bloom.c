@@ -0,0 +1,212 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "bloom.h"
+#include "node.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOM_BLOOM_MASK  (DOM_BLOOM_SIZE - 1ul)
+#define DOM_BLOOM_LIMIT UINT8_MAX
+
+dom_bloom_t *dom_bloom_new(void)
+{
+  dom_bloom_t *self = NULL;
+  self = (dom_bloom_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = self->markcap = DOM_BLOOM_KEYS_CAPACITY;
+  self->keys = (uint32_t *)malloc(self->cap * sizeof(*self->keys));
+  self->marks = (uint64_t *)malloc(self->markcap * sizeof(*self->marks));
+  if (self->keys == NULL || self->marks == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_bloom_destroy(dom_bloom_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->keys);
+    free(self->marks);
+    free(self);
+    self = NULL;
+  }
+}
+
+void dom_bloom_clear(dom_bloom_t *self)
+{
+  self->count = 0ul;
+  self->depth = 0ul;
+  memset(self->counts, 0, sizeof(self->counts));
+}
+
+uint32_t dom_bloom_hash(const int kind, const char *data, const size_t size)
+{
+  uint32_t hash = 0x811c9dc5u ^ (uint32_t)kind;
+  size_t i;
+
+  for (i = 0ul; i < size; i++)
+  {
+    hash ^= (uint8_t)((kind == DOM_BLOOM_TAG) ? tolower((unsigned char)data[i]) : data[i]);
+    hash *= 0x01000193u;
+  }
+
+  return hash;
+}
+
+void dom_bloom_add(dom_bloom_t *self, const uint32_t hash)
+{
+  uint8_t *a = self->counts + (hash & DOM_BLOOM_MASK);
+  uint8_t *b = self->counts + ((hash >> DOM_BLOOM_BITS) & DOM_BLOOM_MASK);
+
+  *a += (*a < DOM_BLOOM_LIMIT);
+  *b += (*b < DOM_BLOOM_LIMIT);
+}
+
+void dom_bloom_remove(dom_bloom_t *self, const uint32_t hash)
+{
+  uint8_t *a = self->counts + (hash & DOM_BLOOM_MASK);
+  uint8_t *b = self->counts + ((hash >> DOM_BLOOM_BITS) & DOM_BLOOM_MASK);
+
+  *a -= (*a < DOM_BLOOM_LIMIT);
+  *b -= (*b < DOM_BLOOM_LIMIT);
+}
+
+bool dom_bloom_may_contain(const dom_bloom_t *self, const uint32_t hash)
+{
+  return 0u != self->counts[hash & DOM_BLOOM_MASK] &&
+         0u != self->counts[(hash >> DOM_BLOOM_BITS) & DOM_BLOOM_MASK];
+}
+
+static void dom_bloom_key(void *ctx, const uint32_t hash)
+{
+  dom_bloom_t *self = (dom_bloom_t *)ctx;
+
+  if (self->count >= self->cap)
+  {
+    void *__old = self->keys;
+    self->keys = NULL;
+    self->keys = (uint32_t *)realloc(__old, (self->cap << 1) * sizeof(*self->keys));
+    if (self->keys == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+    self->cap <<= 1;
+  }
+
+  self->keys[self->count++] = hash;
+  dom_bloom_add(self, hash);
+}
+
+void dom_bloom_node_keys(const dom_tree_node_t *node, void (*fn)(void *, const uint32_t), void *ctx)
+{
+  const dom_tree_node_attr_t *attr = NULL;
+  const char *end = NULL;
+  const char *p = NULL;
+  const char *q = NULL;
+  bool id = false;
+  bool cls = false;
+  uint64_t i;
+
+  fn(ctx, dom_bloom_hash(DOM_BLOOM_TAG, node->name, node->namelen));
+
+  // NOTE: Only the first "id" and "class" count, as for selectors.
+  for (i = 0ul; i < node->attrs_count && !(id && cls); i++)
+  {
+    attr = node->attrs[i];
+    if (attr == NULL || attr->value == NULL)
+    {
+      continue;
+    }
+
+    if (!id && 0 == strcmp(attr->name, "id"))
+    {
+      id = true;
+      fn(ctx, dom_bloom_hash(DOM_BLOOM_ID, attr->value, strlen(attr->value)));
+      continue;
+    }
+
+    if (cls || 0 != strcmp(attr->name, "class"))
+    {
+      continue;
+    }
+
+    cls = true;
+    for (p = attr->value, end = p + strlen(attr->value); p < end; p = q)
+    {
+      while (p < end && isspace((unsigned char)*p))
+      {
+        p++;
+      }
+
+      for (q = p; q < end && !isspace((unsigned char)*q); q++);
+
+      if (q > p)
+      {
+        fn(ctx, dom_bloom_hash(DOM_BLOOM_CLASS, p, (size_t)(q - p)));
+      }
+    }
+  }
+}
+
+void dom_bloom_push(dom_bloom_t *self, const dom_tree_node_t *node)
+{
+  if (self->depth >= self->markcap)
+  {
+    void *__old = self->marks;
+    self->marks = NULL;
+    self->marks = (uint64_t *)realloc(__old, (self->markcap << 1) * sizeof(*self->marks));
+    if (self->marks == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+    self->markcap <<= 1;
+  }
+
+  self->marks[self->depth++] = self->count;
+
+  dom_bloom_node_keys(node, &dom_bloom_key, self);
+}
+
+void dom_bloom_pop(dom_bloom_t *self)
+{
+  uint64_t mark;
+
+  if (0ul == self->depth)
+  {
+    return;
+  }
+
+  mark = self->marks[--self->depth];
+  while (self->count > mark)
+  {
+    dom_bloom_remove(self, self->keys[--self->count]);
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include "node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_BLOOM_BITS 12
+#define DOM_BLOOM_SIZE (1ul << DOM_BLOOM_BITS)
+
+#define DOM_BLOOM_KEYS_CAPACITY (1ul << 6)
+
+/**
+ * @brief What a hash was taken of, mixed into it so a tag, an id and a
+ *        class with the same text do not collide.
+ */
+enum
+{
+  DOM_BLOOM_TAG,
+  DOM_BLOOM_ID,
+  DOM_BLOOM_CLASS,
+};
+
+/**
+ * @brief Counting Bloom filter over the tags, ids and classes of the
+ *        elements on the current path of a depth first walk. Each key
+ *        sets two counters taken from two slices of its hash; a counter
+ *        that reaches its limit stays there, so removal never produces
+ *        a false negative. The keys of the elements pushed are kept on
+ *        a stack so popping does not hash them again.
+ */
+struct dom_bloom
+{
+  size_t cap;
+  uint64_t count;
+  uint32_t *keys;
+  size_t markcap;
+  uint64_t depth;
+  uint64_t *marks;
+  uint8_t counts[DOM_BLOOM_SIZE];
+};
+
+typedef struct dom_bloom dom_bloom_t;
+
+dom_bloom_t *dom_bloom_new(void);
+
+void dom_bloom_destroy(dom_bloom_t *self);
+
+void dom_bloom_clear(dom_bloom_t *self);
+
+/**
+ * @brief Hash a key. Tag names are hashed ignoring case.
+ */
+uint32_t dom_bloom_hash(const int kind, const char *data, const size_t size);
+
+void dom_bloom_add(dom_bloom_t *self, const uint32_t hash);
+
+void dom_bloom_remove(dom_bloom_t *self, const uint32_t hash);
+
+/**
+ * @brief False when no element on the path has the key; true means it
+ *        probably does.
+ */
+bool dom_bloom_may_contain(const dom_bloom_t *self, const uint32_t hash);
+
+/**
+ * @brief Call 'fn' with the hash of the tag, of the id and of every
+ *        class of the element.
+ */
+void dom_bloom_node_keys(const dom_tree_node_t *node, void (*fn)(void *, const uint32_t), void *ctx);
+
+/**
+ * @brief Add the tag, the id and every class of the element.
+ */
+void dom_bloom_push(dom_bloom_t *self, const dom_tree_node_t *node);
+
+/**
+ * @brief Remove the keys of the element pushed last.
+ */
+void dom_bloom_pop(dom_bloom_t *self);
+
+#endif/*BLOOM_H*/
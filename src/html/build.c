@@ -0,0 +1,436 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "attrmap.h"
+#include "build.h"
+#include "node.h"
+#include "scan.h"
+#include "tag.h"
+#include "tree.h"
+#include "walk.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+html_builder_t *html_builder_new(dom_tree_t *tree)
+{
+  html_builder_t *self = NULL;
+  self = (html_builder_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  self->tree = tree;
+  self->stack = dom_tree_node_stack_new(HTML_BUILDER_STACK_CAPACITY);
+  return self;
+}
+
+html_builder_t *html_builder_new_fragment(void)
+{
+  html_builder_t *self = NULL;
+  self = html_builder_new(NULL);
+  self->fragment = true;
+  return self;
+}
+
+void html_builder_destroy(html_builder_t *self)
+{
+  if (self != NULL)
+  {
+    dom_tree_node_stack_destroy(self->stack);
+    self->stack = NULL;
+
+    if (self->events != NULL)
+    {
+      free(self->events);
+      self->events = NULL;
+    }
+
+    free(self);
+    self = NULL;
+  }
+}
+
+/**
+ * @brief Free a subtree the builder owns, attributes included.
+ */
+static void html_builder_free(dom_tree_node_t *root)
+{
+  dom_tree_node_queue_t *que = NULL;
+  dom_tree_node_t *node = NULL;
+  uint64_t i;
+
+  que = dom_tree_node_queue_new(DOM_TREE_NODE_QUEUE_CAPACITY);
+  que = dom_tree_node_queue_enqueue(que, root);
+
+  while (NULL != (node = dom_tree_node_queue_dequeue(que)))
+  {
+    for (i = 0ul; i < node->count; i++)
+    {
+      if (node->children[i] != NULL)
+      {
+        que = dom_tree_node_queue_enqueue(que, node->children[i]);
+      }
+    }
+
+    for (i = 0ul; i < node->attrs_count; i++)
+    {
+      dom_tree_node_attr_destroy(node->attrs[i]);
+    }
+    free(node->attrs);
+    node->attrs = NULL;
+
+    dom_tree_node_destroy(node);
+  }
+
+  dom_tree_node_queue_destroy(que);
+}
+
+void html_builder_discard(html_builder_t *self)
+{
+  uint64_t i;
+
+  if (self == NULL)
+  {
+    return;
+  }
+
+  for (i = 0ul; i < self->count; i++)
+  {
+    if (HTML_BUILDER_NODE == self->events[i].kind)
+    {
+      html_builder_free(self->events[i].node);
+      self->events[i].node = NULL;
+    }
+  }
+  self->count = 0ul;
+
+  while (self->stack->top > 0ul)
+  {
+    html_builder_free(dom_tree_node_stack_pop(self->stack));
+  }
+}
+
+static void html_builder_record(html_builder_t *self, const int kind, const uint8_t *data, const size_t size, dom_tree_node_t *node)
+{
+  if (self->events == NULL)
+  {
+    self->cap = HTML_BUILDER_EVENT_CAPACITY;
+    self->events = (html_builder_event_t *)malloc(self->cap * sizeof(*self->events));
+  }
+  else if (self->count >= self->cap)
+  {
+    void *__old = self->events;
+    self->events = NULL;
+    self->events = (html_builder_event_t *)realloc(__old, (self->cap << 1) * sizeof(*self->events));
+    self->cap <<= 1;
+  }
+
+  if (self->events == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->events[self->count].kind = kind;
+  self->events[self->count].data = data;
+  self->events[self->count].size = size;
+  self->events[self->count].node = node;
+  self->count++;
+}
+
+static void html_builder_doctype(void *ctx, const uint8_t *data, const size_t size)
+{
+  html_builder_t *self = (html_builder_t *)ctx;
+  size_t room;
+
+  if (self->failed)
+  {
+    return;
+  }
+
+  if (self->fragment)
+  {
+    html_builder_record(self, HTML_BUILDER_DOCTYPE, data, size, NULL);
+    return;
+  }
+
+  room = sizeof(self->tree->doctype) - 1ul - strlen(self->tree->doctype);
+
+  strncat(self->tree->doctype, (const char *)data, (size < room) ? size : room);
+}
+
+static void html_builder_open(void *ctx, const uint8_t *name, const size_t size)
+{
+  html_builder_t *self = (html_builder_t *)ctx;
+  dom_tree_node_t *node = NULL;
+
+  if (self->failed)
+  {
+    return;
+  }
+
+  node = dom_tree_node_new(NULL, NULL, DOM_TREE_NODE_DEFAULT_CAPACITY);
+  if (self->tree != NULL)
+  {
+    node->pre = self->tree->count++;
+  }
+
+  if (false == dom_tree_node_append_name(node, name, size))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not write into node name");
+    exit(EXIT_FAILURE);
+  }
+
+  if (false == dom_tree_node_stack_push(self->stack, node))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not push node onto node stack");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void html_builder_attr(void *ctx, const uint8_t *name, const size_t namelen, const uint8_t *value, const size_t vallen)
+{
+  html_builder_t *self = (html_builder_t *)ctx;
+  dom_tree_node_attr_t *attr = NULL;
+  dom_tree_node_t *node = NULL;
+
+  if (self->failed)
+  {
+    return;
+  }
+
+  node = dom_tree_node_stack_peek(self->stack);
+  if (node == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
+    exit(EXIT_FAILURE);
+  }
+
+  attr = dom_tree_node_attr_new(NULL, NULL);
+  memcpy(attr->name, name, (namelen < sizeof(attr->name)) ? namelen : (sizeof(attr->name) - 1ul));
+
+  if (false == dom_tree_node_attr_append_value(attr, value, vallen))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not write into attribute value");
+    exit(EXIT_FAILURE);
+  }
+
+  if (false == dom_tree_node_append_attribute(node, attr))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not append attribute to element");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->tree != NULL && (self->tree->flags & DOM_TREE_INDEX_ATTRS))
+  {
+    dom_attr_map_index(self->tree->ids, self->tree->classes, node, attr);
+  }
+}
+
+static void html_builder_text(void *ctx, const uint8_t *data, const size_t size)
+{
+  html_builder_t *self = (html_builder_t *)ctx;
+  dom_tree_node_t *node = NULL;
+  const uint8_t *end = data + size;
+  const uint8_t *p = NULL;
+
+  if (self->failed)
+  {
+    return;
+  }
+
+  node = dom_tree_node_stack_peek(self->stack);
+  if (node == NULL)
+  {
+    if (self->fragment)
+    {
+      html_builder_record(self, HTML_BUILDER_TEXT, data, size, NULL);
+    }
+    return;
+  }
+
+  // NOTE: The line oriented parser never sees line-breaks, so they are
+  //       dropped here as well to produce the same node bodies.
+  while (data < end)
+  {
+    p = memchr(data, '\n', (size_t)(end - data));
+    if (p == NULL)
+    {
+      p = end;
+    }
+
+    if (p > data && false == dom_tree_node_append_body(node, data, (size_t)(p - data)))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
+      exit(EXIT_FAILURE);
+    }
+
+    data = p + 1;
+  }
+}
+
+static void html_builder_close(void *ctx, const uint8_t *name, const size_t size)
+{
+  html_builder_t *self = (html_builder_t *)ctx;
+  dom_tree_node_t *parent = NULL;
+  dom_tree_node_t *node = NULL;
+
+  if (self->failed)
+  {
+    return;
+  }
+
+  // NOTE: Elements opened before the fragment are closed by the
+  //       stitch pass. Unlike the document root, the fragment's own
+  //       bottom element is closed here and handed over whole.
+  if (self->fragment && 0ul == self->stack->top)
+  {
+    html_builder_record(self, HTML_BUILDER_CLOSE, name, size, NULL);
+    return;
+  }
+
+  if (!self->fragment && 1ul >= self->stack->top)
+  {
+    return;
+  }
+
+  node = dom_tree_node_stack_pop(self->stack);
+  if (node->namelen != size || 0 != memcmp(node->name, name, size))
+  {
+    // NOTE: A chunk that begins inside raw text or a quoted value is
+    //       parsed from the wrong state; leave the verdict to a
+    //       sequential parse of the chunk.
+    if (self->fragment)
+    {
+      html_builder_free(node);
+      self->failed = true;
+      return;
+    }
+    fprintf(stderr, "%s(): %s\n", __func__, "closing tag name does not match open tag name");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->tree != NULL && (self->tree->flags & DOM_TREE_INDEX_TAGS))
+  {
+    dom_tag_index_insert(self->tree->index, node);
+  }
+
+  if (0ul == self->stack->top)
+  {
+    html_builder_record(self, HTML_BUILDER_NODE, NULL, 0ul, node);
+    return;
+  }
+
+  parent = dom_tree_node_stack_peek(self->stack);
+  if (false == dom_tree_node_append(parent, node))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not append child node to parent node");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static const html_walker_t html_builder_walker = {
+  &html_builder_doctype,
+  &html_builder_open,
+  &html_builder_attr,
+  NULL,
+  &html_builder_text,
+  &html_builder_close,
+};
+
+int html_builder_walk(html_builder_t *self, const html_scan_t *scan, const uint8_t *data, const size_t size)
+{
+  return html_walk(scan, data, size, &html_builder_walker, self);
+}
+
+dom_tree_node_t *html_builder_finish(html_builder_t *self)
+{
+  dom_tree_node_t *root = NULL;
+
+  if (1ul != self->stack->top)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+    exit(EXIT_FAILURE);
+  }
+
+  root = dom_tree_node_stack_pop(self->stack);
+  if (self->tree != NULL && (self->tree->flags & DOM_TREE_INDEX_TAGS))
+  {
+    dom_tag_index_insert(self->tree->index, root);
+  }
+  return root;
+}
+
+void html_builder_stitch(html_builder_t *self, const html_builder_t *fragment)
+{
+  const html_builder_event_t *event = NULL;
+  dom_tree_node_t *parent = NULL;
+  uint64_t i;
+
+  for (i = 0ul; i < fragment->count; i++)
+  {
+    event = fragment->events + i;
+
+    switch (event->kind)
+    {
+      case HTML_BUILDER_DOCTYPE:
+        html_builder_doctype(self, event->data, event->size);
+        break;
+
+      case HTML_BUILDER_TEXT:
+        html_builder_text(self, event->data, event->size);
+        break;
+
+      case HTML_BUILDER_CLOSE:
+        html_builder_close(self, event->data, event->size);
+        break;
+
+      case HTML_BUILDER_NODE:
+        parent = dom_tree_node_stack_peek(self->stack);
+        if (parent == NULL)
+        {
+          // NOTE: The document root closed inside the fragment; the
+          //       sequential parse would have kept it on the stack.
+          if (false == dom_tree_node_stack_push(self->stack, event->node))
+          {
+            fprintf(stderr, "%s(): %s\n", __func__, "could not push node onto node stack");
+            exit(EXIT_FAILURE);
+          }
+        }
+        else if (false == dom_tree_node_append(parent, event->node))
+        {
+          fprintf(stderr, "%s(): %s\n", __func__, "could not append child node to parent node");
+          exit(EXIT_FAILURE);
+        }
+        break;
+
+      default:
+        fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown event.kind", event->kind);
+        exit(EXIT_FAILURE);
+    }
+  }
+
+  for (i = 0ul; i < fragment->stack->top; i++)
+  {
+    if (false == dom_tree_node_stack_push(self->stack, fragment->stack->nodes[i]))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not push node onto node stack");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef BUILD_H
+#define BUILD_H
+
+#include "node.h"
+#include "scan.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTML_BUILDER_STACK_CAPACITY (1ul << 10)
+#define HTML_BUILDER_EVENT_CAPACITY (1ul << 5)
+
+enum
+{
+  HTML_BUILDER_DOCTYPE,
+  HTML_BUILDER_TEXT,
+  HTML_BUILDER_NODE,
+  HTML_BUILDER_CLOSE,
+};
+
+/**
+ * @brief Something a fragment could not resolve on its own: text and
+ *        closing tags for elements opened before the fragment, and
+ *        subtrees that closed at the fragment's top level.
+ */
+struct html_builder_event
+{
+  int kind;
+  const uint8_t *data;
+  size_t size;
+  dom_tree_node_t *node;
+};
+
+typedef struct html_builder_event html_builder_event_t;
+
+struct html_builder
+{
+  dom_tree_t *tree;
+  dom_tree_node_stack_t *stack;
+  bool fragment;
+  bool failed;
+  size_t cap;
+  uint64_t count;
+  html_builder_event_t *events;
+};
+
+typedef struct html_builder html_builder_t;
+
+html_builder_t *html_builder_new(dom_tree_t *tree);
+
+/**
+ * @brief Create a builder for a chunk of a larger document. Instead of
+ *        touching a tree it records the events that depend on elements
+ *        opened before the chunk, for html_builder_stitch() to replay.
+ *        A fragment that cannot be built without knowing what was open
+ *        before it is marked failed rather than aborting the program.
+ */
+html_builder_t *html_builder_new_fragment(void);
+
+void html_builder_destroy(html_builder_t *self);
+
+/**
+ * @brief Free the subtrees a fragment built but never handed over: those
+ *        its events refer to and the elements left open on its stack.
+ *        For fragments that will not be stitched.
+ */
+void html_builder_discard(html_builder_t *self);
+
+/**
+ * @brief Build the walked structural index into the builder's tree.
+ *        Returns the html_walk() end state.
+ */
+int html_builder_walk(html_builder_t *self, const html_scan_t *scan, const uint8_t *data, const size_t size);
+
+/**
+ * @brief Pop the finished root node off the builder's stack.
+ */
+dom_tree_node_t *html_builder_finish(html_builder_t *self);
+
+/**
+ * @brief Replay a fragment's events onto the builder and adopt the
+ *        elements the fragment left open, as if the builder itself had
+ *        walked the fragment's chunk.
+ */
+void html_builder_stitch(html_builder_t *self, const html_builder_t *fragment);
+
+#endif/*BUILD_H*/
@@ -10,76 +10,65 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "conv.h"
 #include "graph.h"
+#include "trav.h"
 #include "tree.h"
 
 #include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
 
-void dom_tree_BFS(const dom_tree_t *self)
+graph_t *dom_tree_graph(const dom_tree_t *self)
 {
+  graph_builder_t *builder = NULL;
   graph_t *graph = NULL;
-  graph_node_queue_t *graph_que = NULL;
-  graph_node_t *dst = NULL;
-  graph_node_t *src = NULL;
-  dom_tree_node_queue_t *que = NULL;
+  dom_trav_t *trav = NULL;
   dom_tree_node_t *node = NULL;
+  uint32_t parent;
+  uint32_t child;
   uint64_t i;
-  uint64_t depth;
-
-  depth = 0ul;
-  graph = graph_new(1ul << 5);
-
-  graph_que = graph_node_queue_new((1ul << 5));
-  que = dom_tree_node_queue_new((1ul << 5));
 
-  if (false == dom_tree_node_queue_enqueue(que, self->root))
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue node into node queue");
-    exit(EXIT_FAILURE);
-  }
+  builder = graph_builder_new();
+  trav = dom_trav_new(DOM_TRAV_BFS);
+  dom_trav_reset(trav, self->root);
 
-  src = graph_node_create(graph, self->root->name);
-  if (false == graph_node_queue_enqueue(graph_que, src))
+  // NOTE: Vertices are numbered in the order the traversal queues the
+  //       elements, so the element it returns next is always the next
+  //       vertex.
+  parent = 0u;
+  if (self->root != NULL)
   {
-    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue node into node queue");
-    exit(EXIT_FAILURE);
+    graph_builder_add_vertex(builder, self->root->name, self->root->namelen);
   }
 
-  while (NULL != (node = dom_tree_node_queue_dequeue(que)))
+  while (NULL != (node = dom_trav_next(trav)))
   {
-    dst = graph_node_queue_dequeue(graph_que);
-
-    for (i = node->count; i > 0ul; i--)
+    for (i = 0ul; i < node->count; i++)
     {
-      if (NULL == node->children[i - 1ul])
+      if (NULL == node->children[i])
       {
         continue;
       }
 
-      if (false == dom_tree_node_queue_enqueue(que, node->children[i - 1ul]))
-      {
-        fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue node into node queue");
-        exit(EXIT_FAILURE);
-      }
+      child = graph_builder_add_vertex(builder, node->children[i]->name, node->children[i]->namelen);
+      graph_builder_add_edge(builder, parent, child, (int32_t)trav->depth);
+    }
 
-      src = graph_node_create(graph, node->children[i - 1ul]->name);
+    parent++;
+  }
 
-      graph_add_directed_edge(graph, dst, src, depth);
+  graph = graph_builder_finish(builder);
 
-      if (false == graph_node_queue_enqueue(graph_que, src))
-      {
-        fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue node into node queue");
-        exit(EXIT_FAILURE);
-      }
-    }
-  }
+  dom_trav_destroy(trav);
+  graph_builder_destroy(builder);
+  return graph;
+}
 
-  graph_BFS(graph, 0);
+void dom_tree_BFS(const dom_tree_t *self)
+{
+  graph_t *graph = NULL;
 
-  dom_tree_node_queue_destroy(que);
-  graph_node_queue_destroy(graph_que);
+  graph = dom_tree_graph(self);
+  graph_BFS(graph, 0u);
   graph_destroy(graph);
 }
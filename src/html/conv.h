@@ -1,8 +1,15 @@
 #ifndef CONV_H
 #define CONV_H
 
+#include "graph.h"
 #include "tree.h"
 
+/**
+ * @brief Build the parent to child graph of the tree, one vertex per
+ *        element labelled with its name, in breadth first order.
+ */
+graph_t *dom_tree_graph(const dom_tree_t *self);
+
 void dom_tree_BFS(const dom_tree_t *self);
 
 #endif/*CONV_H*/
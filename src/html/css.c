@@ -0,0 +1,916 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "bloom.h"
+#include "css.h"
+#include "mem.h"
+#include "node.h"
+#include "trav.h"
+#include "tree.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CSS_COMPOUND_CAPACITY (1ul << 3)
+
+/**
+ * @brief The tests of one compound selector while a selector is being
+ *        compiled, with the combinator that joins it to the compound on
+ *        its left.
+ */
+struct css_compound
+{
+  int comb;
+  uint64_t first;
+  uint64_t count;
+};
+
+typedef struct css_compound css_compound_t;
+
+struct css_parser
+{
+  const char *p;
+  css_prog_t *prog;
+  size_t cap;
+  uint64_t count;
+  css_inst_t *tests;
+  size_t compcap;
+  uint64_t compcount;
+  css_compound_t *compounds;
+};
+
+typedef struct css_parser css_parser_t;
+
+static css_prog_t *css_prog_new(void)
+{
+  css_prog_t *self = NULL;
+  self = (css_prog_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = CSS_PROG_CAPACITY;
+  self->strcap = CSS_STRINGS_CAPACITY;
+  self->insts = (css_inst_t *)mem_grow(NULL, self->cap * sizeof(*self->insts));
+  self->strings = (char *)mem_grow(NULL, self->strcap * sizeof(*self->strings));
+  return self;
+}
+
+void css_prog_destroy(css_prog_t *self)
+{
+  if (self != NULL)
+  {
+    if (self->insts != NULL)
+    {
+      free(self->insts);
+      self->insts = NULL;
+    }
+
+    if (self->starts != NULL)
+    {
+      free(self->starts);
+      self->starts = NULL;
+    }
+
+    if (self->strings != NULL)
+    {
+      free(self->strings);
+      self->strings = NULL;
+    }
+
+    free(self);
+    self = NULL;
+  }
+}
+
+static void css_prog_emit(css_prog_t *self, const css_inst_t *inst)
+{
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->insts = (css_inst_t *)mem_grow(self->insts, self->cap * sizeof(*self->insts));
+  }
+  self->insts[self->count++] = *inst;
+}
+
+static uint32_t css_prog_store(css_prog_t *self, const char *data, const size_t size, const bool lower)
+{
+  const uint32_t offset = (uint32_t)self->strsize;
+  size_t i;
+
+  if ((self->strsize + size + 1ul) > self->strcap)
+  {
+    while ((self->strsize + size + 1ul) > self->strcap)
+    {
+      self->strcap <<= 1;
+    }
+    self->strings = (char *)mem_grow(self->strings, self->strcap * sizeof(*self->strings));
+  }
+
+  for (i = 0ul; i < size; i++)
+  {
+    self->strings[offset + i] = lower ? (char)tolower((unsigned char)data[i]) : data[i];
+  }
+  self->strings[offset + size] = '\0';
+  self->strsize += size + 1ul;
+  return offset;
+}
+
+static bool css_is_ident(const int c)
+{
+  return isalnum(c) || c == '-' || c == '_' || c >= 0x80;
+}
+
+static void css_skip_space(css_parser_t *self)
+{
+  while (isspace((unsigned char)*self->p))
+  {
+    self->p++;
+  }
+}
+
+/**
+ * @brief Read an identifier, returning its length.
+ */
+static size_t css_ident(css_parser_t *self, const char **start)
+{
+  *start = self->p;
+  while (css_is_ident((unsigned char)*self->p))
+  {
+    self->p++;
+  }
+  return (size_t)(self->p - *start);
+}
+
+static void css_test_push(css_parser_t *self, const css_inst_t *inst)
+{
+  if (self->count >= self->cap)
+  {
+    self->cap = (self->cap == 0ul) ? CSS_COMPOUND_CAPACITY : (self->cap << 1);
+    self->tests = (css_inst_t *)mem_grow(self->tests, self->cap * sizeof(*self->tests));
+  }
+  self->tests[self->count++] = *inst;
+}
+
+/**
+ * @brief Parse the 'an+b' argument of :nth-child().
+ */
+static bool css_nth(css_parser_t *self, int32_t *a, int32_t *b)
+{
+  char *end = NULL;
+  long n;
+  int sign;
+
+  css_skip_space(self);
+
+  if (0 == strncmp(self->p, "odd", 3ul))
+  {
+    self->p += 3;
+    *a = 2;
+    *b = 1;
+    return true;
+  }
+
+  if (0 == strncmp(self->p, "even", 4ul))
+  {
+    self->p += 4;
+    *a = 2;
+    *b = 0;
+    return true;
+  }
+
+  sign = 1;
+  if (*self->p == '+' || *self->p == '-')
+  {
+    sign = (*self->p++ == '-') ? -1 : 1;
+  }
+
+  n = 1l;
+  if (isdigit((unsigned char)*self->p))
+  {
+    n = strtol(self->p, &end, 10);
+    self->p = end;
+  }
+
+  if (*self->p != 'n' && *self->p != 'N')
+  {
+    if (end == NULL)
+    {
+      return false;
+    }
+    *a = 0;
+    *b = (int32_t)(sign * n);
+    return true;
+  }
+
+  self->p++;
+  *a = (int32_t)(sign * n);
+  *b = 0;
+
+  css_skip_space(self);
+  if (*self->p == '+' || *self->p == '-')
+  {
+    sign = (*self->p++ == '-') ? -1 : 1;
+    css_skip_space(self);
+    if (!isdigit((unsigned char)*self->p))
+    {
+      return false;
+    }
+    *b = (int32_t)(sign * strtol(self->p, &end, 10));
+    self->p = end;
+  }
+
+  return true;
+}
+
+static bool css_attr(css_parser_t *self, css_inst_t *inst)
+{
+  const char *start = NULL;
+  size_t len;
+  char quote;
+
+  css_skip_space(self);
+  len = css_ident(self, &start);
+  if (len == 0ul)
+  {
+    return false;
+  }
+  inst->name = css_prog_store(self->prog, start, len, false);
+  inst->namelen = (uint32_t)len;
+
+  css_skip_space(self);
+
+  switch (*self->p)
+  {
+    case ']':
+      self->p++;
+      inst->cmp = CSS_ATTR_EXISTS;
+      return true;
+
+    case '=':
+      inst->cmp = CSS_ATTR_EQUALS;
+      break;
+
+    case '~':
+      inst->cmp = CSS_ATTR_INCLUDES;
+      break;
+
+    case '|':
+      inst->cmp = CSS_ATTR_DASH;
+      break;
+
+    case '^':
+      inst->cmp = CSS_ATTR_PREFIX;
+      break;
+
+    case '$':
+      inst->cmp = CSS_ATTR_SUFFIX;
+      break;
+
+    case '*':
+      inst->cmp = CSS_ATTR_SUBSTRING;
+      break;
+
+    default:
+      return false;
+  }
+
+  if (inst->cmp != CSS_ATTR_EQUALS)
+  {
+    self->p++;
+    if (*self->p != '=')
+    {
+      return false;
+    }
+  }
+  self->p++;
+
+  css_skip_space(self);
+
+  if (*self->p == '"' || *self->p == '\'')
+  {
+    quote = *self->p++;
+    start = self->p;
+    while (*self->p != '\0' && *self->p != quote)
+    {
+      self->p++;
+    }
+    if (*self->p != quote)
+    {
+      return false;
+    }
+    len = (size_t)(self->p++ - start);
+  }
+  else
+  {
+    len = css_ident(self, &start);
+    if (len == 0ul)
+    {
+      return false;
+    }
+  }
+
+  inst->value = css_prog_store(self->prog, start, len, false);
+  inst->vallen = (uint32_t)len;
+
+  css_skip_space(self);
+  if (*self->p != ']')
+  {
+    return false;
+  }
+  self->p++;
+  return true;
+}
+
+/**
+ * @brief Parse one compound selector into the test buffer, ordered so
+ *        the tests most likely to fail come first.
+ */
+static bool css_compound(css_parser_t *self, const int comb)
+{
+  const char *start = NULL;
+  css_compound_t *compound = NULL;
+  css_inst_t inst;
+  uint64_t first;
+  uint64_t i;
+  uint64_t j;
+  size_t len;
+  bool any;
+
+  first = self->count;
+  any = false;
+
+  if (*self->p == '*')
+  {
+    self->p++;
+    any = true;
+  }
+  else if (0ul < (len = css_ident(self, &start)))
+  {
+    memset(&inst, 0, sizeof(inst));
+    inst.op = CSS_OP_TYPE;
+    inst.name = css_prog_store(self->prog, start, len, true);
+    inst.namelen = (uint32_t)len;
+    inst.hash = dom_bloom_hash(DOM_BLOOM_TAG, start, len);
+    css_test_push(self, &inst);
+  }
+
+  for (;;)
+  {
+    memset(&inst, 0, sizeof(inst));
+
+    switch (*self->p)
+    {
+      case '#':
+      case '.':
+        inst.op = (*self->p++ == '#') ? CSS_OP_ID : CSS_OP_CLASS;
+        len = css_ident(self, &start);
+        if (len == 0ul)
+        {
+          return false;
+        }
+        inst.value = css_prog_store(self->prog, start, len, false);
+        inst.vallen = (uint32_t)len;
+        inst.hash = dom_bloom_hash((inst.op == CSS_OP_ID) ? DOM_BLOOM_ID : DOM_BLOOM_CLASS, start, len);
+        break;
+
+      case '[':
+        self->p++;
+        inst.op = CSS_OP_ATTR;
+        if (false == css_attr(self, &inst))
+        {
+          return false;
+        }
+        break;
+
+      case ':':
+        self->p++;
+        inst.op = CSS_OP_NTH_CHILD;
+        if (0 == strncmp(self->p, "first-child", 11ul))
+        {
+          self->p += 11;
+          inst.a = 0;
+          inst.b = 1;
+          break;
+        }
+        if (0 != strncmp(self->p, "nth-child(", 10ul))
+        {
+          return false;
+        }
+        self->p += 10;
+        if (false == css_nth(self, &inst.a, &inst.b))
+        {
+          return false;
+        }
+        css_skip_space(self);
+        if (*self->p != ')')
+        {
+          return false;
+        }
+        self->p++;
+        break;
+
+      default:
+        if (!any && first == self->count)
+        {
+          return false;
+        }
+
+        // NOTE: Insertion sort on the opcode, which is declared in order
+        //       of selectivity: ids, then types, classes, attributes.
+        for (i = first + 1ul; i < self->count; i++)
+        {
+          inst = self->tests[i];
+          for (j = i; j > first && self->tests[j - 1ul].op > inst.op; j--)
+          {
+            self->tests[j] = self->tests[j - 1ul];
+          }
+          self->tests[j] = inst;
+        }
+
+        if (self->compcount >= self->compcap)
+        {
+          self->compcap = (self->compcap == 0ul) ? CSS_COMPOUND_CAPACITY : (self->compcap << 1);
+          self->compounds = (css_compound_t *)mem_grow(self->compounds, self->compcap * sizeof(*self->compounds));
+        }
+
+        compound = self->compounds + self->compcount++;
+        compound->comb = comb;
+        compound->first = first;
+        compound->count = self->count - first;
+        return true;
+    }
+
+    css_test_push(self, &inst);
+  }
+}
+
+/**
+ * @brief Parse one selector of the list and emit it right to left.
+ */
+static bool css_complex(css_parser_t *self)
+{
+  const css_compound_t *compound = NULL;
+  css_inst_t inst;
+  uint64_t i;
+  uint64_t k;
+  int comb;
+  bool space;
+
+  self->count = 0ul;
+  self->compcount = 0ul;
+  comb = CSS_OP_MATCH;
+
+  for (;;)
+  {
+    if (false == css_compound(self, comb))
+    {
+      return false;
+    }
+
+    space = isspace((unsigned char)*self->p);
+    css_skip_space(self);
+
+    if (*self->p == '>')
+    {
+      self->p++;
+      css_skip_space(self);
+      comb = CSS_OP_CHILD;
+    }
+    else if (space && *self->p != '\0' && *self->p != ',')
+    {
+      comb = CSS_OP_DESCENDANT;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if ((self->prog->nsel & (self->prog->nsel - 1ul)) == 0ul)
+  {
+    self->prog->starts = (uint64_t *)mem_grow(self->prog->starts, ((self->prog->nsel == 0ul) ? 1ul : (self->prog->nsel << 1)) * sizeof(*self->prog->starts));
+  }
+  self->prog->starts[self->prog->nsel++] = self->prog->count;
+
+  for (k = self->compcount; k > 0ul; k--)
+  {
+    compound = self->compounds + (k - 1ul);
+
+    for (i = 0ul; i < compound->count; i++)
+    {
+      css_prog_emit(self->prog, self->tests + compound->first + i);
+    }
+
+    if (compound->comb != CSS_OP_MATCH)
+    {
+      memset(&inst, 0, sizeof(inst));
+      inst.op = compound->comb;
+      css_prog_emit(self->prog, &inst);
+    }
+  }
+
+  memset(&inst, 0, sizeof(inst));
+  inst.op = CSS_OP_MATCH;
+  css_prog_emit(self->prog, &inst);
+  return true;
+}
+
+css_prog_t *css_compile(const char *selector)
+{
+  css_parser_t parser;
+  bool ok;
+
+  memset(&parser, 0, sizeof(parser));
+  parser.p = selector;
+  parser.prog = css_prog_new();
+
+  css_skip_space(&parser);
+
+  for (;;)
+  {
+    ok = css_complex(&parser);
+    if (!ok)
+    {
+      break;
+    }
+
+    css_skip_space(&parser);
+    if (*parser.p == ',')
+    {
+      parser.p++;
+      css_skip_space(&parser);
+      continue;
+    }
+
+    ok = (*parser.p == '\0');
+    break;
+  }
+
+  if (parser.tests != NULL)
+  {
+    free(parser.tests);
+  }
+
+  if (parser.compounds != NULL)
+  {
+    free(parser.compounds);
+  }
+
+  if (!ok)
+  {
+    fprintf(stderr, "%s(): %s at offset %ld\n", __func__, "malformed selector", (long)(parser.p - selector));
+    css_prog_destroy(parser.prog);
+    return NULL;
+  }
+
+  return parser.prog;
+}
+
+static const char *css_attr_value(const dom_tree_node_t *node, const char *name, size_t *len)
+{
+  const dom_tree_node_attr_t *attr = NULL;
+
+  attr = dom_tree_node_get_attribute(node, name);
+  if (attr == NULL)
+  {
+    return NULL;
+  }
+
+  if (attr->value == NULL)
+  {
+    *len = 0ul;
+    return "";
+  }
+
+  *len = strlen(attr->value);
+  return attr->value;
+}
+
+/**
+ * @brief Whether the whitespace separated list holds the word.
+ */
+static bool css_has_word(const char *list, const size_t size, const char *word, const size_t len)
+{
+  size_t i;
+  size_t j;
+
+  for (i = 0ul; i < size; i = j)
+  {
+    while (i < size && isspace((unsigned char)list[i]))
+    {
+      i++;
+    }
+    for (j = i; j < size && !isspace((unsigned char)list[j]); j++);
+
+    if ((j - i) == len && 0 == memcmp(list + i, word, len))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool css_compare(const int cmp, const char *value, const size_t size, const char *other, const size_t len)
+{
+  size_t i;
+
+  switch (cmp)
+  {
+    case CSS_ATTR_EXISTS:
+      return true;
+
+    case CSS_ATTR_EQUALS:
+      return size == len && 0 == memcmp(value, other, len);
+
+    case CSS_ATTR_INCLUDES:
+      return css_has_word(value, size, other, len);
+
+    case CSS_ATTR_DASH:
+      return size >= len && 0 == memcmp(value, other, len) && (size == len || value[len] == '-');
+
+    case CSS_ATTR_PREFIX:
+      return 0ul < len && size >= len && 0 == memcmp(value, other, len);
+
+    case CSS_ATTR_SUFFIX:
+      return 0ul < len && size >= len && 0 == memcmp(value + (size - len), other, len);
+
+    case CSS_ATTR_SUBSTRING:
+      if (len == 0ul)
+      {
+        return false;
+      }
+      for (i = 0ul; (i + len) <= size; i++)
+      {
+        if (value[i] == other[0] && 0 == memcmp(value + i, other, len))
+        {
+          return true;
+        }
+      }
+      return false;
+
+    default:
+      fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown attribute operator", cmp);
+      exit(EXIT_FAILURE);
+  }
+}
+
+static bool css_type_eq(const dom_tree_node_t *node, const char *name, const size_t len)
+{
+  size_t i;
+
+  if (node->namelen != len)
+  {
+    return false;
+  }
+
+  for (i = 0ul; i < len; i++)
+  {
+    if (tolower((unsigned char)node->name[i]) != name[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool css_nth_child(const dom_tree_node_t *node, const int32_t a, const int32_t b)
+{
+  const dom_tree_node_t *parent = node->parent;
+  int64_t n;
+  uint64_t i;
+
+  n = 1l;
+  if (parent != NULL)
+  {
+    for (i = 0ul; i < parent->count && parent->children[i] != node; i++)
+    {
+      if (parent->children[i] != NULL)
+      {
+        n++;
+      }
+    }
+  }
+
+  return css_nth_match(a, b, n);
+}
+
+bool css_nth_match(const int32_t a, const int32_t b, const int64_t n)
+{
+  if (a == 0)
+  {
+    return n == b;
+  }
+
+  return ((n - b) / a) >= 0 && ((n - b) % a) == 0;
+}
+
+bool css_test(const css_prog_t *prog, const css_inst_t *inst, const dom_tree_node_t *node)
+{
+  const char *value = NULL;
+  size_t size;
+
+  switch (inst->op)
+  {
+    case CSS_OP_ID:
+      value = css_attr_value(node, "id", &size);
+      return value != NULL && css_compare(CSS_ATTR_EQUALS, value, size, prog->strings + inst->value, inst->vallen);
+
+    case CSS_OP_TYPE:
+      return css_type_eq(node, prog->strings + inst->name, inst->namelen);
+
+    case CSS_OP_CLASS:
+      value = css_attr_value(node, "class", &size);
+      return value != NULL && css_has_word(value, size, prog->strings + inst->value, inst->vallen);
+
+    case CSS_OP_ATTR:
+      value = css_attr_value(node, prog->strings + inst->name, &size);
+      return value != NULL && css_compare(inst->cmp, value, size, prog->strings + inst->value, inst->vallen);
+
+    case CSS_OP_NTH_CHILD:
+      return css_nth_child(node, inst->a, inst->b);
+
+    default:
+      fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown instruction", inst->op);
+      exit(EXIT_FAILURE);
+  }
+}
+
+bool css_run(const css_prog_t *prog, uint64_t pc, const dom_tree_node_t *node)
+{
+  const css_inst_t *inst = NULL;
+  const dom_tree_node_t *anc = NULL;
+
+  for (;; pc++)
+  {
+    inst = prog->insts + pc;
+
+    switch (inst->op)
+    {
+      case CSS_OP_MATCH:
+        return true;
+
+      case CSS_OP_CHILD:
+        node = node->parent;
+        if (node == NULL)
+        {
+          return false;
+        }
+        break;
+
+      case CSS_OP_DESCENDANT:
+        for (anc = node->parent; anc != NULL; anc = anc->parent)
+        {
+          if (css_run(prog, pc + 1ul, anc))
+          {
+            return true;
+          }
+        }
+        return false;
+
+      default:
+        if (!css_test(prog, inst, node))
+        {
+          return false;
+        }
+        break;
+    }
+  }
+}
+
+bool css_match(const css_prog_t *prog, const dom_tree_node_t *node)
+{
+  uint64_t i;
+
+  for (i = 0ul; i < prog->nsel; i++)
+  {
+    if (css_run(prog, prog->starts[i], node))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool css_reject(const css_prog_t *prog, uint64_t pc, const dom_bloom_t *bloom)
+{
+  const css_inst_t *inst = NULL;
+  bool above = false;
+
+  if (bloom == NULL)
+  {
+    return false;
+  }
+
+  for (;; pc++)
+  {
+    inst = prog->insts + pc;
+
+    switch (inst->op)
+    {
+      case CSS_OP_MATCH:
+        return false;
+
+      case CSS_OP_CHILD:
+      case CSS_OP_DESCENDANT:
+        above = true;
+        break;
+
+      case CSS_OP_ID:
+      case CSS_OP_TYPE:
+      case CSS_OP_CLASS:
+        if (above && !dom_bloom_may_contain(bloom, inst->hash))
+        {
+          return true;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+bool css_tests_ancestors(const css_prog_t *prog)
+{
+  const css_inst_t *inst = NULL;
+  bool above = false;
+
+  for (inst = prog->insts; inst < prog->insts + prog->count; inst++)
+  {
+    switch (inst->op)
+    {
+      case CSS_OP_MATCH:
+        above = false;
+        break;
+
+      case CSS_OP_CHILD:
+      case CSS_OP_DESCENDANT:
+        above = true;
+        break;
+
+      case CSS_OP_ID:
+      case CSS_OP_TYPE:
+      case CSS_OP_CLASS:
+        if (above)
+        {
+          return true;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return false;
+}
+
+dom_tree_node_list_t *css_select(const dom_tree_t *tree, const css_prog_t *prog, dom_tree_node_list_t *results)
+{
+  dom_trav_t *trav = NULL;
+  dom_tree_node_t *node = NULL;
+  uint64_t i;
+
+  trav = dom_trav_new(DOM_TRAV_PREORDER);
+  if (css_tests_ancestors(prog))
+  {
+    dom_trav_track_ancestors(trav);
+  }
+  dom_trav_reset(trav, tree->root);
+
+  while (NULL != (node = dom_trav_next(trav)))
+  {
+    for (i = 0ul; i < prog->nsel; i++)
+    {
+      if (!css_reject(prog, prog->starts[i], trav->bloom) && css_run(prog, prog->starts[i], node))
+      {
+        results = dom_tree_node_list_append(results, node);
+        break;
+      }
+    }
+  }
+
+  dom_trav_destroy(trav);
+  return results;
+}
@@ -0,0 +1,136 @@
+#ifndef CSS_H
+#define CSS_H
+
+#include "bloom.h"
+#include "node.h"
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CSS_PROG_CAPACITY    (1ul << 4)
+#define CSS_STRINGS_CAPACITY (1ul << 7)
+
+/**
+ * @brief Matcher instructions. The tests check the current node; the
+ *        combinators move to its parent or to some ancestor.
+ */
+enum
+{
+  CSS_OP_MATCH,
+  CSS_OP_ID,
+  CSS_OP_TYPE,
+  CSS_OP_CLASS,
+  CSS_OP_ATTR,
+  CSS_OP_NTH_CHILD,
+  CSS_OP_CHILD,
+  CSS_OP_DESCENDANT,
+};
+
+/**
+ * @brief Attribute selector operators.
+ */
+enum
+{
+  CSS_ATTR_EXISTS,
+  CSS_ATTR_EQUALS,    /* [a=v]  */
+  CSS_ATTR_INCLUDES,  /* [a~=v] */
+  CSS_ATTR_DASH,      /* [a|=v] */
+  CSS_ATTR_PREFIX,    /* [a^=v] */
+  CSS_ATTR_SUFFIX,    /* [a$=v] */
+  CSS_ATTR_SUBSTRING, /* [a*=v] */
+};
+
+struct css_inst
+{
+  int op;
+  int cmp;
+  uint32_t name;
+  uint32_t namelen;
+  uint32_t value;
+  uint32_t vallen;
+  int32_t a;
+  int32_t b;
+  uint32_t hash;
+};
+
+typedef struct css_inst css_inst_t;
+
+/**
+ * @brief A compiled selector list. Each selector is laid out from its
+ *        rightmost compound to its leftmost, the tests of a compound
+ *        ordered from the most to the least selective, and ends with a
+ *        MATCH. 'starts' holds the first instruction of each selector.
+ *        Type, id and class tests carry the ancestor filter hash of
+ *        what they test for.
+ */
+struct css_prog
+{
+  size_t cap;
+  uint64_t count;
+  css_inst_t *insts;
+  size_t nsel;
+  uint64_t *starts;
+  size_t strcap;
+  uint64_t strsize;
+  char *strings;
+};
+
+typedef struct css_prog css_prog_t;
+
+/**
+ * @brief Compile a selector list such as "div.result > a[href^=http]".
+ *        Supports type, universal, #id, .class and attribute selectors,
+ *        :nth-child() and :first-child, and the descendant and child
+ *        combinators. Returns NULL when the selector is malformed.
+ */
+css_prog_t *css_compile(const char *selector);
+
+void css_prog_destroy(css_prog_t *self);
+
+/**
+ * @brief Run one test instruction against the node alone.
+ */
+bool css_test(const css_prog_t *prog, const css_inst_t *inst, const dom_tree_node_t *node);
+
+/**
+ * @brief Whether position 'n', counting from one, is of the form an+b.
+ */
+bool css_nth_match(const int32_t a, const int32_t b, const int64_t n);
+
+/**
+ * @brief Run the program from 'pc' against the node, moving leftwards
+ *        through the selector and upwards through the tree. The first
+ *        failing test rejects the node.
+ */
+bool css_run(const css_prog_t *prog, uint64_t pc, const dom_tree_node_t *node);
+
+/**
+ * @brief Whether the ancestor filter proves the selector from 'pc'
+ *        cannot match: every type, id and class test left of the first
+ *        combinator must hold for some ancestor. Without a filter
+ *        nothing is rejected.
+ */
+bool css_reject(const css_prog_t *prog, uint64_t pc, const dom_bloom_t *bloom);
+
+/**
+ * @brief Whether any selector tests an ancestor's type, id or class,
+ *        which is what the ancestor filter can answer.
+ */
+bool css_tests_ancestors(const css_prog_t *prog);
+
+/**
+ * @brief Whether the node matches any selector of the program.
+ */
+bool css_match(const css_prog_t *prog, const dom_tree_node_t *node);
+
+/**
+ * @brief Append every node matching the program to the results, in
+ *        document order. Returns the results list, which may have
+ *        moved. A Bloom filter of the ancestors seen on the way down
+ *        rejects most nodes whose selectors need an ancestor they do
+ *        not have, before any ancestor is looked at.
+ */
+dom_tree_node_list_t *css_select(const dom_tree_t *tree, const css_prog_t *prog, dom_tree_node_list_t *results);
+
+#endif/*CSS_H*/
@@ -0,0 +1,368 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "extract.h"
+#include "node.h"
+#include "stat.h"
+#include "tag.h"
+#include "tree.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Score added to a container by its own tag.
+ */
+static double dom_extract_prior(const uint32_t tag)
+{
+  switch (tag)
+  {
+    case DOM_TAG_ARTICLE:
+    case DOM_TAG_MAIN:
+      return 25.0;
+
+    case DOM_TAG_DIV:
+    case DOM_TAG_SECTION:
+      return 5.0;
+
+    case DOM_TAG_PRE:
+    case DOM_TAG_TD:
+    case DOM_TAG_BLOCKQUOTE:
+      return 3.0;
+
+    case DOM_TAG_ADDRESS:
+    case DOM_TAG_OL:
+    case DOM_TAG_UL:
+    case DOM_TAG_DL:
+    case DOM_TAG_DD:
+    case DOM_TAG_DT:
+    case DOM_TAG_LI:
+    case DOM_TAG_FORM:
+      return -3.0;
+
+    case DOM_TAG_H1:
+    case DOM_TAG_H2:
+    case DOM_TAG_H3:
+    case DOM_TAG_H4:
+    case DOM_TAG_H5:
+    case DOM_TAG_H6:
+    case DOM_TAG_TH:
+      return -5.0;
+
+    case DOM_TAG_HEADER:
+    case DOM_TAG_NAV:
+    case DOM_TAG_ASIDE:
+    case DOM_TAG_FOOTER:
+      return -25.0;
+
+    default:
+      return 0.0;
+  }
+}
+
+/**
+ * @brief Elements whose text is never content.
+ */
+static bool dom_extract_skip(const uint32_t tag)
+{
+  switch (tag)
+  {
+    case DOM_TAG_SCRIPT:
+    case DOM_TAG_STYLE:
+    case DOM_TAG_NOSCRIPT:
+    case DOM_TAG_TEMPLATE:
+    case DOM_TAG_HEAD:
+    case DOM_TAG_NAV:
+    case DOM_TAG_ASIDE:
+    case DOM_TAG_FOOTER:
+    case DOM_TAG_FORM:
+    case DOM_TAG_BUTTON:
+    case DOM_TAG_SELECT:
+    case DOM_TAG_IFRAME:
+    case DOM_TAG_SVG:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Elements that hold a paragraph of text rather than contain
+ *        one; their text scores the element above them.
+ */
+static bool dom_extract_inline(const uint32_t tag)
+{
+  switch (tag)
+  {
+    case DOM_TAG_P:
+    case DOM_TAG_A:
+    case DOM_TAG_B:
+    case DOM_TAG_I:
+    case DOM_TAG_EM:
+    case DOM_TAG_STRONG:
+    case DOM_TAG_SPAN:
+    case DOM_TAG_CODE:
+    case DOM_TAG_SMALL:
+    case DOM_TAG_LI:
+    case DOM_TAG_H1:
+    case DOM_TAG_H2:
+    case DOM_TAG_H3:
+    case DOM_TAG_H4:
+    case DOM_TAG_H5:
+    case DOM_TAG_H6:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Elements that start a new line in the extracted text.
+ */
+static bool dom_extract_block(const uint32_t tag)
+{
+  switch (tag)
+  {
+    case DOM_TAG_ARTICLE:
+    case DOM_TAG_BLOCKQUOTE:
+    case DOM_TAG_BR:
+    case DOM_TAG_DD:
+    case DOM_TAG_DIV:
+    case DOM_TAG_DT:
+    case DOM_TAG_FIGCAPTION:
+    case DOM_TAG_H1:
+    case DOM_TAG_H2:
+    case DOM_TAG_H3:
+    case DOM_TAG_H4:
+    case DOM_TAG_H5:
+    case DOM_TAG_H6:
+    case DOM_TAG_LI:
+    case DOM_TAG_MAIN:
+    case DOM_TAG_P:
+    case DOM_TAG_PRE:
+    case DOM_TAG_SECTION:
+    case DOM_TAG_TABLE:
+    case DOM_TAG_TR:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+static double dom_extract_points(const dom_tree_node_t *node)
+{
+  double points = 1.0;
+  size_t i;
+
+  for (i = 0ul; i < node->bodylen; i++)
+  {
+    points += (node->body[i] == ',');
+  }
+
+  return points + (((node->bodylen / 100ul) < 3ul) ? (double)(node->bodylen / 100ul) : 3.0);
+}
+
+static double dom_extract_link_density(const dom_tree_stat_t *stat, const uint64_t i)
+{
+  return (0ul == stat->text[i]) ? 0.0 : ((double)stat->link_text[i] / (double)stat->text[i]);
+}
+
+/**
+ * @brief Append the body with runs of white space collapsed, after a
+ *        line break or a space.
+ */
+static void dom_extract_append(dom_extract_t *self, const dom_tree_node_t *node, const bool block)
+{
+  void *__old = NULL;
+  bool space = true;
+  size_t i;
+
+  if ((self->len + node->bodylen + 2ul) > self->cap)
+  {
+    while ((self->len + node->bodylen + 2ul) > self->cap)
+    {
+      self->cap <<= 1;
+    }
+
+    __old = self->text;
+    self->text = NULL;
+    self->text = (char *)realloc(__old, self->cap * sizeof(*self->text));
+    if (self->text == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (0ul < self->len && self->text[self->len - 1ul] != '\n')
+  {
+    self->text[self->len++] = block ? '\n' : ' ';
+  }
+
+  for (i = 0ul; i < node->bodylen; i++)
+  {
+    if (isspace((unsigned char)node->body[i]))
+    {
+      if (!space)
+      {
+        self->text[self->len++] = ' ';
+      }
+      space = true;
+      continue;
+    }
+
+    self->text[self->len++] = node->body[i];
+    space = false;
+  }
+
+  while (0ul < self->len && self->text[self->len - 1ul] == ' ')
+  {
+    self->len--;
+  }
+
+  self->text[self->len] = '\0';
+}
+
+dom_extract_t *dom_extract_new(dom_tree_t *tree, const dom_tree_stat_t *stat)
+{
+  dom_tree_stat_t *own = NULL;
+  dom_extract_t *self = NULL;
+  dom_tree_node_t *node = NULL;
+  dom_tree_node_t *target = NULL;
+  double *score = NULL;
+  double points;
+  double best;
+  uint64_t end;
+  uint64_t i;
+
+  self = (dom_extract_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = DOM_EXTRACT_TEXT_CAPACITY;
+  self->text = (char *)calloc(self->cap, sizeof(*self->text));
+  if (self->text == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  if (tree->root == NULL)
+  {
+    return self;
+  }
+
+  if (stat == NULL)
+  {
+    stat = own = dom_tree_stat_new(tree);
+  }
+
+  score = (double *)calloc(stat->count, sizeof(*score));
+  if (score == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  // NOTE: Paragraph-like elements score their container, others are
+  //       the container of their own text.
+  for (i = 0ul; i < stat->count; i++)
+  {
+    node = tree->nodes->nodes[i];
+    if (node->bodylen < DOM_EXTRACT_TEXT_MIN || dom_extract_skip(stat->tag[i]))
+    {
+      continue;
+    }
+
+    points = dom_extract_points(node);
+    target = dom_extract_inline(stat->tag[i]) ? node->parent : node;
+    if (target == NULL)
+    {
+      continue;
+    }
+
+    score[target->pre] += points;
+    if (target->parent != NULL)
+    {
+      score[target->parent->pre] += points / 2.0;
+    }
+  }
+
+  best = 0.0;
+  for (i = 0ul; i < stat->count; i++)
+  {
+    if (score[i] <= 0.0)
+    {
+      continue;
+    }
+
+    score[i] = (score[i] + dom_extract_prior(stat->tag[i])) * (1.0 - dom_extract_link_density(stat, i));
+    if (self->node == NULL || score[i] > best)
+    {
+      self->node = tree->nodes->nodes[i];
+      best = score[i];
+    }
+  }
+
+  if (self->node == NULL)
+  {
+    self->node = tree->root;
+  }
+
+  self->score = best;
+
+  // NOTE: Walk the chosen subtree in document order, jumping over the
+  //       subtrees left out. Link density only drops blocks, so links
+  //       inside a paragraph keep their text.
+  end = self->node->pre + 1ul + dom_tree_node_descendants(self->node);
+  for (i = self->node->pre; i < end; i++)
+  {
+    node = tree->nodes->nodes[i];
+
+    if (node != self->node && (dom_extract_skip(stat->tag[i]) ||
+        (dom_extract_block(stat->tag[i]) && dom_extract_link_density(stat, i) > DOM_EXTRACT_LINK_MAX)))
+    {
+      i += dom_tree_node_descendants(node);
+      continue;
+    }
+
+    if (0ul < node->bodylen)
+    {
+      dom_extract_append(self, node, dom_extract_block(stat->tag[i]));
+    }
+  }
+
+  free(score);
+  dom_tree_stat_destroy(own);
+  return self;
+}
+
+void dom_extract_destroy(dom_extract_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->text);
+    free(self);
+    self = NULL;
+  }
+}
@@ -0,0 +1,49 @@
+#ifndef EXTRACT_H
+#define EXTRACT_H
+
+#include "node.h"
+#include "stat.h"
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_EXTRACT_TEXT_CAPACITY (1ul << 10)
+
+/**
+ * @brief Bodies shorter than TEXT_MIN bytes score nothing; subtrees
+ *        whose text is more than LINK_MAX link text are left out of the
+ *        extracted text.
+ */
+#define DOM_EXTRACT_TEXT_MIN 25ul
+#define DOM_EXTRACT_LINK_MAX 0.5
+
+/**
+ * @brief The main content of a page: its subtree, that subtree's score
+ *        and its text with boilerplate removed, one line per block.
+ */
+struct dom_extract
+{
+  dom_tree_node_t *node;
+  double score;
+  size_t cap;
+  size_t len;
+  char *text;
+};
+
+typedef struct dom_extract dom_extract_t;
+
+/**
+ * @brief Find the main content of a parsed page. Every body of at least
+ *        DOM_EXTRACT_TEXT_MIN bytes scores its container and the one
+ *        above, by length and commas. A container's score then gains
+ *        its tag prior, favouring article and main over nav, aside and
+ *        footer, and is scaled down by its link density. The best one
+ *        is the main content. 'stat' may be NULL, in which case the
+ *        statistics are gathered here.
+ */
+dom_extract_t *dom_extract_new(dom_tree_t *tree, const dom_tree_stat_t *stat);
+
+void dom_extract_destroy(dom_extract_t *self);
+
+#endif/*EXTRACT_H*/
@@ -10,10 +10,13 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "lex.h"
+#include "task.h"
 #include "token.h"
 
 #include <ctype.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,12 +25,175 @@
 
 #define MAX_WORD_BUF 64
 
+#define LEX_CHUNK_MIN (1ul << 16)
+
+struct lex_chunk
+{
+  const uint8_t *data;
+  size_t size;
+  token_queue_t *que;
+};
+
+typedef struct lex_chunk lex_chunk_t;
+
+/**
+ * @brief Copy a run of word or number characters into the token.
+ */
+static size_t lex_run(token_t *tok, const int kind, int (*is)(int), const uint8_t *p, const size_t n)
+{
+  size_t i;
+
+  for (i = 0ul; i < n && i < (MAX_WORD_BUF - 1) && p[i] && is(p[i]); i++);
+
+  if (i >= (MAX_WORD_BUF - 1) && i < n && p[i] && is(p[i]))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not write to word buffer, buffer full");
+    exit(EXIT_FAILURE);
+  }
+
+  tok->data = calloc(1u+i, sizeof(*p));
+  if (tok->data == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  tok->size = 1u+i;
+  tok->kind = kind;
+
+  memcpy(tok->data, p, i);
+  return i;
+}
+
+/**
+ * @brief Read one token from at most 'n' bytes, returning the number of
+ *        bytes it spans.
+ */
+static size_t lex_token(token_t *tok, const uint8_t *p, const size_t n)
+{
+  switch (*p)
+  {
+    case '[':
+      tok->kind = KIND_OPEN_SQUARE_BRACKET;
+      break;
+
+    case ']':
+      tok->kind = KIND_CLOSE_SQUARE_BRACKET;
+      break;
+
+    case '(':
+      tok->kind = KIND_OPEN_PARENTHESIS;
+      break;
+
+    case ')':
+      tok->kind = KIND_CLOSE_PARENTHESIS;
+      break;
+
+    case '.':
+      tok->kind = KIND_PERIOD;
+      break;
+
+    case ':':
+      tok->kind = KIND_COLON;
+      break;
+
+    case ';':
+      tok->kind = KIND_SEMI_COLON;
+      break;
+
+    case ',':
+      tok->kind = KIND_COMMA;
+      break;
+
+    case ' ':
+      tok->kind = KIND_SPACE;
+      break;
+
+    case '<':
+      tok->kind = KIND_LT_CARET;
+      break;
+
+    case '>':
+      tok->kind = KIND_RT_CARET;
+      break;
+
+    case '/':
+      tok->kind = KIND_FWD_SLASH;
+      break;
+
+    case '=':
+      tok->kind = KIND_EQUALS;
+      break;
+
+    case '"':
+      tok->kind = KIND_DBL_QUOT;
+      break;
+
+    case '\'':
+      tok->kind = KIND_SNG_QUOT;
+      break;
+
+    case '!':
+      tok->kind = KIND_EXCL;
+      break;
+
+    case '-':
+      tok->kind = KIND_DASH;
+      break;
+
+    case '_':
+      tok->kind = KIND_UNDERSCORE;
+      break;
+
+    case '+':
+      tok->kind = KIND_PLUS;
+      break;
+
+    case '^':
+      tok->kind = KIND_CARET;
+      break;
+
+    case '?':
+      tok->kind = KIND_QMARK;
+      break;
+
+    case '&':
+      tok->kind = KIND_AMP;
+      break;
+
+    case '|':
+      tok->kind = KIND_VBAR;
+      break;
+
+    case '{':
+      tok->kind = KIND_LT_CURLY_BRACKET;
+      break;
+
+    case '}':
+      tok->kind = KIND_RT_CURLY_BRACKET;
+      break;
+
+    default:
+      if (isalpha(*p))
+      {
+        return lex_run(tok, KIND_WORD, &isalpha, p, n);
+      }
+      else if (isdigit(*p))
+      {
+        return lex_run(tok, KIND_NUMBER, &isdigit, p, n);
+      }
+
+      fprintf(stderr, "%s(): %s (%c / 0x%x)\n", __func__, "illegal character", *p, *p);
+      exit(EXIT_FAILURE);
+  }
+
+  return 1ul;
+}
+
 token_queue_t *lex(uint8_t **line, const ssize_t size, int64_t *j)
 {
   token_queue_t *que = NULL;
   token_t *tok = NULL;
-  uint8_t buf[MAX_WORD_BUF];
-  uint32_t i;
+  size_t n;
 
   que = token_queue_new(TOKEN_QUEUE_CAPACITY);
 
@@ -39,165 +205,8 @@ token_queue_t *lex(uint8_t **line, const ssize_t size, int64_t *j)
       return que;
     }
 
-    switch (**line)
-    {
-      case '[':
-        tok->kind = KIND_OPEN_SQUARE_BRACKET;
-        break;
-
-      case ']':
-        tok->kind = KIND_CLOSE_SQUARE_BRACKET;
-        break;
-
-      case '(':
-        tok->kind = KIND_OPEN_PARENTHESIS;
-        break;
-
-      case ')':
-        tok->kind = KIND_CLOSE_PARENTHESIS;
-        break;
-
-      case '.':
-        tok->kind = KIND_PERIOD;
-        break;
-
-      case ':':
-        tok->kind = KIND_COLON;
-        break;
-
-      case ';':
-        tok->kind = KIND_SEMI_COLON;
-        break;
-
-      case ',':
-        tok->kind = KIND_COMMA;
-        break;
-
-      case ' ':
-        tok->kind = KIND_SPACE;
-        break;
-
-      case '<':
-        tok->kind = KIND_LT_CARET;
-        break;
-
-      case '>':
-        tok->kind = KIND_RT_CARET;
-        break;
-
-      case '/':
-        tok->kind = KIND_FWD_SLASH;
-        break;
-
-      case '=':
-        tok->kind = KIND_EQUALS;
-        break;
-
-      case '"':
-        tok->kind = KIND_DBL_QUOT;
-        break;
-
-      case '\'':
-        tok->kind = KIND_SNG_QUOT;
-        break;
-
-      case '!':
-        tok->kind = KIND_EXCL;
-        break;
-
-      case '-':
-        tok->kind = KIND_DASH;
-        break;
-
-      case '_':
-        tok->kind = KIND_UNDERSCORE;
-        break;
-
-      case '+':
-        tok->kind = KIND_PLUS;
-        break;
-
-      case '^':
-        tok->kind = KIND_CARET;
-        break;
-
-      case '?':
-        tok->kind = KIND_QMARK;
-        break;
-
-      case '&':
-        tok->kind = KIND_AMP;
-        break;
-
-      case '|':
-        tok->kind = KIND_VBAR;
-        break;
-
-      case '{':
-        tok->kind = KIND_LT_CURLY_BRACKET;
-        break;
-
-      case '}':
-        tok->kind = KIND_RT_CURLY_BRACKET;
-        break;
-
-      default:
-        if (isalpha(**line))
-        {
-          memset(buf, 0, MAX_WORD_BUF * sizeof(*buf));
-          for (i = 0u; *j < size && i < (MAX_WORD_BUF - 1) && **line && isalpha(**line); (*line)++, i++, *j += 1)
-          {
-            buf[i] = **line;
-          }
-          if (i >= (MAX_WORD_BUF - 1) && **line && isalpha(**line))
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "could not write to word buffer, buffer full");
-            exit(EXIT_FAILURE);
-          }
-          (*line)--; *j -= 1;
-
-          tok->data = calloc(1u+i, sizeof(*buf));
-          if (tok->data == NULL)
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-            exit(EXIT_FAILURE);
-          }
-          tok->size = 1u+i;
-          tok->kind = KIND_WORD;
-
-          memcpy(tok->data, buf, i);
-          break;
-        }
-        else if (isdigit(**line))
-        {
-          memset(buf, 0, MAX_WORD_BUF * sizeof(*buf));
-          for (i = 0u; *j < size && i < (MAX_WORD_BUF - 1) && **line && isdigit(**line); (*line)++, i++, *j += 1)
-          {
-            buf[i] = **line;
-          }
-          if (i >= (MAX_WORD_BUF - 1) && **line && isdigit(**line))
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "could not write to word buffer, buffer full");
-            exit(EXIT_FAILURE);
-          }
-          (*line)--; *j -= 1;
-
-          tok->data = calloc(1u+i, sizeof(*buf));
-          if (tok->data == NULL)
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-            exit(EXIT_FAILURE);
-          }
-          tok->size = 1u+i;
-          tok->kind = KIND_NUMBER;
-
-          memcpy(tok->data, buf, i);
-          break;
-        }
-
-        fprintf(stderr, "%s(): %s (%c / 0x%x)\n", __func__, "illegal character", **line, **line);
-        exit(EXIT_FAILURE);
-    }
+    n = lex_token(tok, *line, (size_t)(size - *j)) - 1ul;
+    *line += n; *j += (int64_t)n;
 
     if (false == token_queue_next(que))
     {
@@ -208,3 +217,133 @@ token_queue_t *lex(uint8_t **line, const ssize_t size, int64_t *j)
 
   return que;
 }
+
+static void lex_chunk(void *arg)
+{
+  lex_chunk_t *chunk = (lex_chunk_t *)arg;
+  const uint8_t *p = chunk->data;
+  const uint8_t *end = chunk->data + chunk->size;
+  token_t tok;
+
+  chunk->que = token_queue_new(TOKEN_QUEUE_CAPACITY);
+
+  while (p < end)
+  {
+    // NOTE: Lines are lexed one at a time by the sequential parser, so
+    //       line-breaks only separate tokens.
+    if (*p == '\n' || *p == '\0')
+    {
+      p++;
+      continue;
+    }
+
+    memset(&tok, 0, sizeof(tok));
+    p += lex_token(&tok, p, (size_t)(end - p));
+    chunk->que = token_queue_append(chunk->que, &tok);
+  }
+}
+
+/**
+ * @brief Join a word or number split by a chunk boundary onto the
+ *        token before it.
+ */
+static void lex_join(token_t *tok, token_t *tail)
+{
+  const size_t a = tok->size - 1ul;
+  const size_t b = tail->size - 1ul;
+
+  if ((a + b) > (MAX_WORD_BUF - 1))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not write to word buffer, buffer full");
+    exit(EXIT_FAILURE);
+  }
+
+  void *__old = tok->data;
+  tok->data = NULL;
+  tok->data = realloc(__old, 1ul + a + b);
+  if (tok->data == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  memcpy((uint8_t *)tok->data + a, tail->data, b + 1ul);
+  tok->size = 1ul + a + b;
+
+  free(tail->data);
+  tail->data = NULL;
+}
+
+token_queue_t *lex_parallel(const uint8_t *data, const size_t size, uint64_t nthreads)
+{
+  token_queue_t *que = NULL;
+  lex_chunk_t *chunks = NULL;
+  token_t *last = NULL;
+  const uint8_t *p = NULL;
+  size_t count;
+  uint64_t n;
+  uint64_t i;
+  uint64_t k;
+
+  if (nthreads == 0ul)
+  {
+    nthreads = task_cpu_count();
+  }
+
+  n = size / LEX_CHUNK_MIN;
+  n = (n < 1ul) ? 1ul : (n > nthreads) ? nthreads : n;
+
+  chunks = (lex_chunk_t *)calloc(n, sizeof(*chunks));
+  if (chunks == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0ul; i < n; i++)
+  {
+    chunks[i].data = data + ((i * size) / n);
+    chunks[i].size = (((i + 1ul) * size) / n) - ((i * size) / n);
+  }
+
+  task_run(&lex_chunk, chunks, sizeof(*chunks), n, nthreads);
+
+  for (count = 0ul, i = 0ul; i < n; i++)
+  {
+    count += token_queue_size(chunks[i].que);
+  }
+
+  que = token_queue_new((count > 0ul) ? count : 1ul);
+
+  // NOTE: Quotes and tags do not change how a byte is lexed, so every
+  //       chunk lexes the same under any entry state. The one state a
+  //       chunk can inherit is an unfinished word or number, which is
+  //       resolved here by joining it onto the token before it.
+  for (i = 0ul; i < n; i++)
+  {
+    k = 0ul;
+    p = chunks[i].data;
+
+    if (0ul < i && 0ul < chunks[i].size && last != NULL &&
+        ((isalpha(p[-1]) && isalpha(p[0])) || (isdigit(p[-1]) && isdigit(p[0]))))
+    {
+      lex_join(last, chunks[i].que->toks);
+      k = 1ul;
+    }
+
+    for (; k < token_queue_size(chunks[i].que); k++)
+    {
+      que = token_queue_append(que, chunks[i].que->toks + k);
+    }
+
+    if (0ul < token_queue_size(que))
+    {
+      last = que->toks + (que->w - 1ul);
+    }
+
+    token_queue_destroy(chunks[i].que);
+  }
+
+  free(chunks);
+  return que;
+}
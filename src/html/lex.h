@@ -3,8 +3,17 @@
 
 #include "token.h"
 
+#include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h>
 
 token_queue_t *lex(uint8_t **line, const ssize_t size, int64_t *j);
 
+/**
+ * @brief Lex a whole buffer as one token stream, splitting it into
+ *        chunks lexed on separate threads. A zero thread count means
+ *        one per online processor.
+ */
+token_queue_t *lex_parallel(const uint8_t *data, const size_t size, uint64_t nthreads);
+
 #endif/*LEX_H*/
@@ -0,0 +1,522 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "graph.h"
+#include "link.h"
+#include "mem.h"
+#include "node.h"
+#include "trav.h"
+#include "tree.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOM_LINKS_MAGIC   "blitzlnk"
+#define DOM_LINKS_VERSION 1u
+#define DOM_LINKS_BOM     0x01020304u
+
+/**
+ * @brief Leading block of a saved link table, followed by 'count' rows
+ *        and 'strsize' bytes of NUL terminated URLs.
+ */
+struct dom_links_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t bom;
+  uint64_t count;
+  uint64_t nedges;
+  uint64_t ncomponents;
+  uint64_t strsize;
+};
+
+typedef struct dom_links_header dom_links_header_t;
+
+dom_links_t *dom_links_new(const int flags)
+{
+  dom_links_t *self = NULL;
+  self = (dom_links_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->flags = flags;
+  self->builder = graph_builder_new();
+  self->cap = DOM_LINKS_BUFFER_CAPACITY;
+  self->buf = (char *)mem_grow(NULL, self->cap * sizeof(*self->buf));
+  self->tcap = DOM_LINKS_BUFFER_CAPACITY;
+  self->targets = (uint32_t *)mem_grow(NULL, self->tcap * sizeof(*self->targets));
+  return self;
+}
+
+void dom_links_destroy(dom_links_t *self)
+{
+  if (self != NULL)
+  {
+    graph_builder_destroy(self->builder);
+    free(self->buf);
+    free(self->targets);
+    free(self);
+    self = NULL;
+  }
+}
+
+/**
+ * @brief Return the length of "http:" or "https:" when the URL starts
+ *        with either and "//", zero otherwise.
+ */
+static size_t dom_links_scheme(const char *url, const size_t size)
+{
+  const char http[] = "https://";
+  size_t n;
+
+  // NOTE: Schemes are case-insensitive; "http" is "https" less the 's'.
+  for (n = 0ul; n < size && n < 5ul && (char)tolower((unsigned char)url[n]) == http[n]; n++)
+  {
+  }
+
+  if (n == 4ul && n < size && url[n] == ':')
+  {
+    n = 5ul;
+  }
+  else if (n == 5ul && n < size && url[n] == ':')
+  {
+    n = 6ul;
+  }
+  else
+  {
+    return 0ul;
+  }
+
+  if (size < n + 2ul || url[n] != '/' || url[n + 1ul] != '/')
+  {
+    return 0ul;
+  }
+
+  return n;
+}
+
+/**
+ * @brief Whether the reference names a scheme, such as "mailto:".
+ */
+static bool dom_links_has_scheme(const char *url, const size_t size)
+{
+  size_t i;
+
+  if (size == 0ul || !isalpha((unsigned char)url[0]))
+  {
+    return false;
+  }
+
+  for (i = 1ul; i < size; i++)
+  {
+    if (url[i] == ':')
+    {
+      return true;
+    }
+    if (!isalnum((unsigned char)url[i]) && url[i] != '+' && url[i] != '-' && url[i] != '.')
+    {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Return the end of the host of an absolute URL and, in 'path',
+ *        the end of its path.
+ */
+static size_t dom_links_host(const char *url, const size_t size, size_t *path)
+{
+  size_t i = dom_links_scheme(url, size) + 2ul;
+
+  while (i < size && url[i] != '/' && url[i] != '?')
+  {
+    i++;
+  }
+
+  *path = i;
+  while (*path < size && url[*path] != '?')
+  {
+    (*path)++;
+  }
+
+  return i;
+}
+
+static void dom_links_put(dom_links_t *self, size_t *len, const char *data, const size_t size)
+{
+  if ((*len + size + 1ul) > self->cap)
+  {
+    while ((*len + size + 1ul) > self->cap)
+    {
+      self->cap <<= 1;
+    }
+    self->buf = (char *)mem_grow(self->buf, self->cap * sizeof(*self->buf));
+  }
+
+  memcpy(self->buf + *len, data, size);
+  *len += size;
+  self->buf[*len] = '\0';
+}
+
+/**
+ * @brief Lowercase the scheme and host, give an empty path a '/' and
+ *        remove "." and ".." segments from the path, in place.
+ */
+static size_t dom_links_normalize(dom_links_t *self, size_t len)
+{
+  size_t host;
+  size_t path;
+  size_t r;
+  size_t w;
+  size_t s;
+  size_t i;
+
+  host = dom_links_host(self->buf, len, &path);
+  for (i = 0ul; i < host; i++)
+  {
+    self->buf[i] = (char)tolower((unsigned char)self->buf[i]);
+  }
+
+  if (host == len || self->buf[host] == '?')
+  {
+    dom_links_put(self, &len, "/", 1ul);
+    memmove(self->buf + host + 1ul, self->buf + host, len - host - 1ul);
+    self->buf[host] = '/';
+    path++;
+  }
+
+  // NOTE: Segments are copied down one at a time; ".." drops the last
+  //       one written, never going above the host.
+  r = w = host;
+  while (r < path)
+  {
+    s = r + 1ul;
+    while (s < path && self->buf[s] != '/')
+    {
+      s++;
+    }
+
+    if (s - r == 2ul && self->buf[r + 1ul] == '.')
+    {
+      if (s == path)
+      {
+        self->buf[w++] = '/';
+      }
+    }
+    else if (s - r == 3ul && self->buf[r + 1ul] == '.' && self->buf[r + 2ul] == '.')
+    {
+      while (w > host && self->buf[--w] != '/')
+      {
+      }
+      if (s == path)
+      {
+        self->buf[w++] = '/';
+      }
+    }
+    else
+    {
+      memmove(self->buf + w, self->buf + r, s - r);
+      w += s - r;
+    }
+
+    r = s;
+  }
+
+  if (w == host)
+  {
+    self->buf[w++] = '/';
+  }
+
+  memmove(self->buf + w, self->buf + path, len - path);
+  len = w + (len - path);
+  self->buf[len] = '\0';
+  return len;
+}
+
+/**
+ * @brief Resolve the reference against the base URL into the buffer.
+ *        Returns its length, or zero when it is not an http or https
+ *        URL.
+ */
+static size_t dom_links_resolve(dom_links_t *self, const char *base, const char *href, size_t size)
+{
+  const size_t baselen = (base != NULL) ? strlen(base) : 0ul;
+  const char *end = NULL;
+  size_t len = 0ul;
+  size_t host;
+  size_t path;
+  size_t i;
+
+  while (size > 0ul && isspace((unsigned char)*href))
+  {
+    href++;
+    size--;
+  }
+
+  end = memchr(href, '#', size);
+  if (end != NULL)
+  {
+    size = (size_t)(end - href);
+  }
+
+  while (size > 0ul && isspace((unsigned char)href[size - 1ul]))
+  {
+    size--;
+  }
+
+  if (0ul < dom_links_scheme(href, size))
+  {
+    dom_links_put(self, &len, href, size);
+    return dom_links_normalize(self, len);
+  }
+
+  if (dom_links_has_scheme(href, size) || 0ul == dom_links_scheme(base, baselen))
+  {
+    return 0ul;
+  }
+
+  host = dom_links_host(base, baselen, &path);
+
+  if (size >= 2ul && href[0] == '/' && href[1] == '/')
+  {
+    dom_links_put(self, &len, base, dom_links_scheme(base, baselen));
+  }
+  else if (size > 0ul && href[0] == '/')
+  {
+    dom_links_put(self, &len, base, host);
+  }
+  else if (size == 0ul || href[0] == '?')
+  {
+    dom_links_put(self, &len, base, (size == 0ul) ? baselen : path);
+  }
+  else
+  {
+    for (i = path; i > host && base[i - 1ul] != '/'; i--)
+    {
+    }
+    dom_links_put(self, &len, base, (i > host) ? i : host);
+    if (i <= host)
+    {
+      dom_links_put(self, &len, "/", 1ul);
+    }
+  }
+
+  dom_links_put(self, &len, href, size);
+  return dom_links_normalize(self, len);
+}
+
+/**
+ * @brief Intern the URL now in the buffer, cut down to its site when
+ *        asked to.
+ */
+static uint32_t dom_links_vertex(dom_links_t *self, size_t len)
+{
+  size_t path;
+
+  if (self->flags & DOM_LINKS_SITES)
+  {
+    len = dom_links_host(self->buf, len, &path);
+  }
+
+  return graph_builder_intern(self->builder, self->buf, len);
+}
+
+static int dom_links_compare(const void *a, const void *b)
+{
+  const uint32_t x = *(const uint32_t *)a;
+  const uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+void dom_links_add(dom_links_t *self, const char *url, const dom_tree_t *tree)
+{
+  const dom_tree_node_attr_t *href = NULL;
+  dom_tree_node_t *node = NULL;
+  dom_trav_t *trav = NULL;
+  char *base = NULL;
+  uint32_t src;
+  uint32_t dst;
+  uint64_t i;
+  size_t len;
+
+  len = dom_links_resolve(self, NULL, url, strlen(url));
+  if (len == 0ul)
+  {
+    dom_links_put(self, &len, url, strlen(url));
+  }
+
+  // NOTE: Links resolve against the normalized page URL, which has no
+  //       fragment, so "" and "#top" name the page itself. The buffer is
+  //       reused by every resolution, hence the copy.
+  base = (char *)mem_grow(NULL, len + 1ul);
+  memcpy(base, self->buf, len);
+  base[len] = '\0';
+
+  src = dom_links_vertex(self, len);
+  self->ntargets = 0ul;
+
+  trav = dom_trav_new(DOM_TRAV_PREORDER);
+  dom_trav_reset(trav, tree->root);
+
+  while (NULL != (node = dom_trav_next(trav)))
+  {
+    if (node->namelen != 1ul || (node->name[0] != 'a' && node->name[0] != 'A'))
+    {
+      continue;
+    }
+
+    href = dom_tree_node_get_attribute(node, "href");
+    if (href == NULL || href->value == NULL)
+    {
+      continue;
+    }
+
+    len = dom_links_resolve(self, base, href->value, href->vallen);
+    if (len == 0ul)
+    {
+      continue;
+    }
+
+    dst = dom_links_vertex(self, len);
+    if (dst == src)
+    {
+      continue;
+    }
+
+    if (self->ntargets >= self->tcap)
+    {
+      self->tcap <<= 1;
+      self->targets = (uint32_t *)mem_grow(self->targets, self->tcap * sizeof(*self->targets));
+    }
+
+    self->targets[self->ntargets++] = dst;
+  }
+
+  dom_trav_destroy(trav);
+  free(base);
+
+  qsort(self->targets, self->ntargets, sizeof(*self->targets), &dom_links_compare);
+
+  for (i = 0ul; i < self->ntargets; i++)
+  {
+    if (i == 0ul || self->targets[i] != self->targets[i - 1ul])
+    {
+      graph_builder_add_edge(self->builder, src, self->targets[i], 1);
+    }
+  }
+}
+
+graph_t *dom_links_graph(dom_links_t *self)
+{
+  return graph_builder_finish(self->builder);
+}
+
+int dom_links_save(const graph_t *graph, const double *rank, const uint32_t *component, const char *path)
+{
+  char const mode[] = "wb";
+  dom_links_header_t header;
+  dom_links_row_t row;
+  FILE *fd = NULL;
+  uint64_t i;
+  int r;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DOM_LINKS_MAGIC, sizeof(header.magic));
+  header.version = DOM_LINKS_VERSION;
+  header.bom = DOM_LINKS_BOM;
+  header.count = graph->count;
+  header.nedges = graph->nedges;
+  header.strsize = (graph->labels != NULL) ? graph->strsize : 0ul;
+
+  for (i = 0ul; i < graph->count; i++)
+  {
+    header.ncomponents += (component[i] == (uint32_t)i);
+  }
+
+  fd = fopen(path, mode);
+  if (fd == NULL)
+  {
+    fprintf(stderr, "fopen() failed to open a file on the disk\n");
+    return (-1);
+  }
+
+  r = (1ul == fwrite(&header, sizeof(header), 1ul, fd)) ? 0 : (-1);
+
+  for (i = 0ul; r == 0 && i < graph->count; i++)
+  {
+    memset(&row, 0, sizeof(row));
+    row.label = (graph->labels != NULL) ? graph->labels[i] : 0ul;
+    row.rank = rank[i];
+    row.component = component[i];
+    row.degree = (uint32_t)graph_degree(graph, (uint32_t)i);
+
+    if (1ul != fwrite(&row, sizeof(row), 1ul, fd))
+    {
+      r = (-1);
+    }
+  }
+
+  if (r == 0 && header.strsize != fwrite(graph->strings, sizeof(*graph->strings), header.strsize, fd))
+  {
+    r = (-1);
+  }
+
+  if (r != 0)
+  {
+    fprintf(stderr, "fwrite() failed to write all bytes to file\n");
+  }
+
+  if (EOF == fclose(fd))
+  {
+    fprintf(stderr, "cannot close file handler\n");
+    r = (-1);
+  }
+
+  fd = NULL;
+  return r;
+}
+
+int dom_links_rank(dom_links_t *self, const char *path, const uint64_t nthreads)
+{
+  graph_t *graph = NULL;
+  graph_t *in = NULL;
+  double *rank = NULL;
+  uint32_t *component = NULL;
+  uint64_t n;
+  int r;
+
+  graph = dom_links_graph(self);
+  in = graph_transpose(graph);
+
+  rank = graph_pagerank(graph, in, GRAPH_PAGERANK_DAMPING, GRAPH_PAGERANK_ITERATIONS, GRAPH_PAGERANK_EPSILON, nthreads);
+  component = graph_components(graph, &n, nthreads);
+
+  r = dom_links_save(graph, rank, component, path);
+
+  free(rank);
+  free(component);
+  graph_destroy(in);
+  graph_destroy(graph);
+  return r;
+}
@@ -0,0 +1,82 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include "graph.h"
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_LINKS_BUFFER_CAPACITY (1ul << 8)
+
+/**
+ * @brief Link graph options. SITES collapses every URL to its scheme
+ *        and host, giving one vertex per site and dropping the links
+ *        within a site.
+ */
+#define DOM_LINKS_SITES (1 << 0)
+
+/**
+ * @brief Collects the links of many documents into one directed graph.
+ *        URLs are interned to vertex ids as they are seen, so a page
+ *        that is linked to before it is added keeps its vertex.
+ */
+struct dom_links
+{
+  int flags;
+  graph_builder_t *builder;
+  size_t cap;
+  char *buf;
+  size_t tcap;
+  uint64_t ntargets;
+  uint32_t *targets;
+};
+
+typedef struct dom_links dom_links_t;
+
+/**
+ * @brief One row of a saved link table. The labels are offsets into the
+ *        strings that follow the rows.
+ */
+struct dom_links_row
+{
+  uint64_t label;
+  double rank;
+  uint32_t component;
+  uint32_t degree;
+};
+
+typedef struct dom_links_row dom_links_row_t;
+
+dom_links_t *dom_links_new(const int flags);
+
+void dom_links_destroy(dom_links_t *self);
+
+/**
+ * @brief Add an edge from the document at 'url' to every http or https
+ *        page its <a href> elements point at, relative references
+ *        resolved against 'url' and fragments dropped. Each target is
+ *        linked to once per document.
+ */
+void dom_links_add(dom_links_t *self, const char *url, const dom_tree_t *tree);
+
+/**
+ * @brief Return the graph of the links added so far; the collector
+ *        starts over empty.
+ */
+graph_t *dom_links_graph(dom_links_t *self);
+
+/**
+ * @brief Write a table of one row per vertex: its rank, component and
+ *        out degree, then the URLs. Returns zero on success.
+ */
+int dom_links_save(const graph_t *graph, const double *rank, const uint32_t *component, const char *path);
+
+/**
+ * @brief Build the graph of the links added so far, rank its vertices,
+ *        label its components on up to 'nthreads' threads and save the
+ *        table to 'path'. Returns zero on success.
+ */
+int dom_links_rank(dom_links_t *self, const char *path, const uint64_t nthreads);
+
+#endif/*LINK_H*/
@@ -11,6 +11,7 @@
  * Licensed under the Academic Free License version 3.0.
  */
 #include "node.h"
+#include "serial.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -77,20 +78,15 @@ void dom_tree_node_destroy(dom_tree_node_t *self)
 
 bool dom_tree_node_append_name(dom_tree_node_t *self, const void *data, const size_t size)
 {
-  if (self->name == NULL)
-  {
-    self->name = (char *)calloc(DOM_TREE_NODE_NAMELEN_DEFAULT, sizeof(*self->name));
-  }
-  else
+  // NOTE: The buffer always holds one more byte than the name so it
+  //       stays terminated however large the appended data is.
+  const size_t prev_threshold = (self->name == NULL) ? 0ul : (1ul + self->namelen / DOM_TREE_NODE_NAMELEN_DEFAULT);
+  const size_t curr_threshold = 1ul + (size + self->namelen) / DOM_TREE_NODE_NAMELEN_DEFAULT;
+  if (curr_threshold > prev_threshold)
   {
-    const size_t prev_threshold = self->namelen / DOM_TREE_NODE_NAMELEN_DEFAULT;
-    const size_t curr_threshold = (size + self->namelen) / DOM_TREE_NODE_NAMELEN_DEFAULT;
-    if (curr_threshold > prev_threshold)
-    {
-      void *__old = self->name;
-      self->name = NULL;
-      self->name = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_NAMELEN_DEFAULT * sizeof(self->name));
-    }
+    void *__old = self->name;
+    self->name = NULL;
+    self->name = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_NAMELEN_DEFAULT * sizeof(*self->name));
   }
   if (self->name == NULL)
   {
@@ -99,25 +95,21 @@ bool dom_tree_node_append_name(dom_tree_node_t *self, const void *data, const si
   }
   memcpy((self->name + self->namelen), data, size);
   self->namelen += size;
+  self->name[self->namelen] = '\0';
   return true;
 }
 
 bool dom_tree_node_append_body(dom_tree_node_t *self, const void *data, const size_t size)
 {
-  if (self->body == NULL)
-  {
-    self->body = (char *)calloc(DOM_TREE_NODE_BODYLEN_DEFAULT, sizeof(*self->body));
-  }
-  else
+  // NOTE: The buffer always holds one more byte than the body so it
+  //       stays terminated however large the appended data is.
+  const size_t prev_threshold = (self->body == NULL) ? 0ul : (1ul + self->bodylen / DOM_TREE_NODE_BODYLEN_DEFAULT);
+  const size_t curr_threshold = 1ul + (size + self->bodylen) / DOM_TREE_NODE_BODYLEN_DEFAULT;
+  if (curr_threshold > prev_threshold)
   {
-    const size_t prev_threshold = self->bodylen / DOM_TREE_NODE_BODYLEN_DEFAULT;
-    const size_t curr_threshold = (size + self->bodylen) / DOM_TREE_NODE_BODYLEN_DEFAULT;
-    if (curr_threshold > prev_threshold)
-    {
-      void *__old = self->body;
-      self->body = NULL;
-      self->body = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_BODYLEN_DEFAULT * sizeof(self->body));
-    }
+    void *__old = self->body;
+    self->body = NULL;
+    self->body = (char *)realloc(__old, curr_threshold * DOM_TREE_NODE_BODYLEN_DEFAULT * sizeof(*self->body));
   }
   if (self->body == NULL)
   {
@@ -126,33 +118,24 @@ bool dom_tree_node_append_body(dom_tree_node_t *self, const void *data, const si
   }
   memcpy((self->body + self->bodylen), data, size);
   self->bodylen += size;
+  self->body[self->bodylen] = '\0';
   return true;
 }
 
 bool dom_tree_node_append(dom_tree_node_t *self, dom_tree_node_t *node)
 {
-  if (self->count >= self->cap)
-  {
-    return false;
-  }
-
   node->parent = self;
 
   if (self->children == NULL)
   {
     self->children = (dom_tree_node_t **)calloc(self->cap, sizeof(*self->children));
   }
-  else
+  else if (self->count >= self->cap)
   {
-    const size_t prev_threshold = self->count / self->cap;
-    const size_t curr_threshold = (1ul + self->count) / self->cap;
-    if (curr_threshold > prev_threshold)
-    {
-      void *__old = self->children;
-      self->children = NULL;
-      self->children = (dom_tree_node_t **)realloc(__old, (1ul + self->count) * self->cap * sizeof(*self->children));
-      self->cap = curr_threshold * self->cap;
-    }
+    void *__old = self->children;
+    self->children = NULL;
+    self->children = (dom_tree_node_t **)realloc(__old, (self->cap << 1) * sizeof(*self->children));
+    self->cap <<= 1;
   }
 
   if (self->children == NULL)
@@ -167,11 +150,6 @@ bool dom_tree_node_append(dom_tree_node_t *self, dom_tree_node_t *node)
 
 bool dom_tree_node_append_attribute(dom_tree_node_t *self, dom_tree_node_attr_t *attr)
 {
-  if (self->attrs_count >= 16ul)
-  {
-    return false;
-  }
-
   if (self->attrs == NULL)
   {
     self->attrs = (dom_tree_node_attr_t **)calloc(1ul, sizeof(*self->attrs));
@@ -193,84 +171,69 @@ bool dom_tree_node_append_attribute(dom_tree_node_t *self, dom_tree_node_attr_t
   return true;
 }
 
-void dom_tree_node_print_open(const dom_tree_node_t *self)
+dom_tree_node_attr_t *dom_tree_node_get_attribute(const dom_tree_node_t *self, const char *name)
 {
-  if (self == NULL)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
-    exit(EXIT_FAILURE);
-  }
-
   uint64_t i;
 
-  printf("<%s", self->name);
-
-  if (0ul < self->attrs_count)
-  {
-    printf("%c", ' ');
-  }
-
   for (i = 0ul; i < self->attrs_count; i++)
   {
-    if (self->attrs == NULL || self->attrs[i] == NULL)
-    {
-      fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
-      exit(EXIT_FAILURE);
-    }
-
-    printf("%s=\"%s\"", self->attrs[i]->name, self->attrs[i]->value);
-
-    if ((1ul + i) < self->attrs_count)
+    if (self->attrs[i] != NULL && 0 == strcmp(self->attrs[i]->name, name))
     {
-      printf("%c", ' ');
+      return self->attrs[i];
     }
   }
 
-  printf(">%s", self->body);
+  return NULL;
 }
 
-void dom_tree_node_print_close(const dom_tree_node_t *self)
+bool dom_tree_node_is_ancestor(const dom_tree_node_t *self, const dom_tree_node_t *node)
 {
-  if (self == NULL)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
-    exit(EXIT_FAILURE);
-  }
-  printf("</%s>", self->name);
+  return self->pre < node->pre && node->post < self->post;
+}
+
+uint64_t dom_tree_node_descendants(const dom_tree_node_t *self)
+{
+  // NOTE: Of the nodes before this one in preorder, all but its
+  //       ancestors are finished before it in postorder.
+  return self->post + self->depth - self->pre;
 }
 
 void dom_tree_node_print(const dom_tree_node_t *self)
 {
+  dom_buffer_t *out = NULL;
+
   if (self == NULL)
   {
     fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
     exit(EXIT_FAILURE);
   }
-  printf("<%s>%s</%s>", self->name, self->body, self->name);
+
+  out = dom_buffer_new_sink(DOM_BUFFER_CAPACITY, &dom_buffer_fwrite, stdout);
+  dom_buffer_write(out, "<", 1ul);
+  dom_buffer_write(out, self->name, self->namelen);
+  dom_buffer_write(out, ">", 1ul);
+  if (self->body != NULL)
+  {
+    dom_buffer_write_text(out, self->body, self->bodylen);
+  }
+  dom_buffer_write(out, "</", 2ul);
+  dom_buffer_write(out, self->name, self->namelen);
+  dom_buffer_write(out, ">", 1ul);
+  dom_buffer_destroy(out);
 }
 
 void __dom_tree_node_print(const dom_tree_node_t *self)
 {
+  dom_buffer_t *out = NULL;
+
   if (self == NULL)
   {
     return;
   }
 
-  uint64_t i;
-
-  dom_tree_node_print_open(self);
-
-  for (i = 0ul; i < self->count; i++)
-  {
-    if (self->children == NULL || self->children[i] == NULL)
-    {
-      continue;
-    }
-
-    __dom_tree_node_print(self->children[i]);
-  }
-
-  dom_tree_node_print_close(self);
+  out = dom_buffer_new_sink(DOM_BUFFER_CAPACITY, &dom_buffer_fwrite, stdout);
+  dom_tree_node_serialize(self, out);
+  dom_buffer_destroy(out);
 }
 
 static void dom_tree_node_stack_setup(dom_tree_node_stack_t *self, const size_t size, const size_t cap)
@@ -295,7 +258,7 @@ dom_tree_node_stack_t *dom_tree_node_stack_new(const size_t cap)
 
 void dom_tree_node_stack_destroy(dom_tree_node_stack_t *self)
 {
-  if (self == NULL)
+  if (self != NULL)
   {
     free(self);
     self = NULL;
@@ -352,7 +315,7 @@ dom_tree_node_queue_t *dom_tree_node_queue_new(const size_t cap)
 
 void dom_tree_node_queue_destroy(dom_tree_node_queue_t *self)
 {
-  if (self == NULL)
+  if (self != NULL)
   {
     free(self);
     self = NULL;
@@ -363,6 +326,8 @@ dom_tree_node_queue_t *dom_tree_node_queue_enqueue(dom_tree_node_queue_t *self,
 {
   if ((self->w - self->r) >= self->cap)
   {
+    const size_t cap = self->cap;
+    const uint64_t k = self->r % cap;
     self->cap += DOM_TREE_NODE_QUEUE_CAPACITY;
     const size_t size = offsetof(dom_tree_node_queue_t, nodes[self->cap]);
     void *__old = NULL;
@@ -374,6 +339,13 @@ dom_tree_node_queue_t *dom_tree_node_queue_enqueue(dom_tree_node_queue_t *self,
       fprintf(stderr, "%s(): %s\n", __func__, "memory error");
       exit(EXIT_FAILURE);
     }
+
+    // NOTE: The oldest entries of a full ring run from 'k' to the end
+    //       of the old array; move them to the end of the new one so
+    //       the ring keeps its order under the larger capacity.
+    memmove(self->nodes + (self->cap - (cap - k)), self->nodes + k, (cap - k) * sizeof(*self->nodes));
+    self->r = self->cap - (cap - k);
+    self->w = self->r + cap;
   }
   self->nodes[self->w++ % self->cap] = node;
   return self;
@@ -387,3 +359,51 @@ dom_tree_node_t *dom_tree_node_queue_dequeue(dom_tree_node_queue_t *self)
   }
   return self->nodes[self->r++ % self->cap];
 }
+
+static void dom_tree_node_list_setup(dom_tree_node_list_t *self, const size_t cap)
+{
+  self->cap = cap;
+  self->count = 0ul;
+}
+
+dom_tree_node_list_t *dom_tree_node_list_new(const size_t cap)
+{
+  const size_t size = offsetof(dom_tree_node_list_t, nodes[cap]);
+  dom_tree_node_list_t *self = NULL;
+  self = (dom_tree_node_list_t *)malloc(size);
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  dom_tree_node_list_setup(self, cap);
+  return self;
+}
+
+void dom_tree_node_list_destroy(dom_tree_node_list_t *self)
+{
+  if (self != NULL)
+  {
+    free(self);
+    self = NULL;
+  }
+}
+
+dom_tree_node_list_t *dom_tree_node_list_append(dom_tree_node_list_t *self, dom_tree_node_t *node)
+{
+  if (self->count >= self->cap)
+  {
+    const size_t cap = (self->cap < 1ul) ? DOM_TREE_NODE_LIST_CAPACITY : (self->cap << 1);
+    void *__old = self;
+    self = NULL;
+    self = (dom_tree_node_list_t *)realloc(__old, offsetof(dom_tree_node_list_t, nodes[cap]));
+    if (self == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+    self->cap = cap;
+  }
+  self->nodes[self->count++] = node;
+  return self;
+}
@@ -21,6 +21,10 @@ struct dom_tree_node
   size_t cap;
   uint64_t count;
   uint64_t attrs_count;
+  uint64_t pre;
+  uint64_t post;
+  uint64_t depth;
+  uint32_t tag;
   dom_tree_node_attr_t **attrs;
   struct dom_tree_node *parent;
   struct dom_tree_node **children;
@@ -40,6 +44,22 @@ bool dom_tree_node_append(dom_tree_node_t *self, dom_tree_node_t *node);
 
 bool dom_tree_node_append_attribute(dom_tree_node_t *self, dom_tree_node_attr_t *attr);
 
+/**
+ * @brief Return the first attribute with the name, or NULL.
+ */
+dom_tree_node_attr_t *dom_tree_node_get_attribute(const dom_tree_node_t *self, const char *name);
+
+/**
+ * @brief Whether 'self' is a proper ancestor of 'node', from the 'pre'
+ *        and 'post' numbers given by dom_tree_number().
+ */
+bool dom_tree_node_is_ancestor(const dom_tree_node_t *self, const dom_tree_node_t *node);
+
+/**
+ * @brief The number of elements below the node, from its numbering.
+ */
+uint64_t dom_tree_node_descendants(const dom_tree_node_t *self);
+
 void __dom_tree_node_print(const dom_tree_node_t *self);
 void dom_tree_node_print(const dom_tree_node_t *self);
 
@@ -84,4 +104,21 @@ dom_tree_node_queue_t *dom_tree_node_queue_enqueue(dom_tree_node_queue_t *self,
 
 dom_tree_node_t *dom_tree_node_queue_dequeue(dom_tree_node_queue_t *self);
 
+#define DOM_TREE_NODE_LIST_CAPACITY (1ul << 5)
+
+struct dom_tree_node_list
+{
+  size_t cap;
+  uint64_t count;
+  dom_tree_node_t *nodes[];
+};
+
+typedef struct dom_tree_node_list dom_tree_node_list_t;
+
+dom_tree_node_list_t *dom_tree_node_list_new(const size_t cap);
+
+void dom_tree_node_list_destroy(dom_tree_node_list_t *self);
+
+dom_tree_node_list_t *dom_tree_node_list_append(dom_tree_node_list_t *self, dom_tree_node_t *node);
+
 #endif/*NODE_H*/
@@ -10,14 +10,21 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "attrmap.h"
+#include "build.h"
 #include "io.h"
 #include "lex.h"
 #include "node.h"
 #include "parse.h"
+#include "scan.h"
 #include "state.h"
+#include "tag.h"
 #include "token.h"
+#include "task.h"
 #include "tree.h"
+#include "walk.h"
 
+#include <ctype.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -58,12 +65,40 @@ int __parse_tag_open(dom_tree_t *tree, dom_tree_node_stack_t *stack,
 
 #define MAXBUF ((1u << 12) - 1u)
 
+#define HTML_PARSE_CHUNK_MIN (1ul << 16)
+
+struct html_chunk
+{
+  const uint8_t *data;
+  size_t size;
+  html_builder_t *builder;
+  int state;
+};
+
+typedef struct html_chunk html_chunk_t;
+
 dom_tree_t *tree = NULL;
 dom_tree_node_stack_t *stack = NULL;
 dom_tree_node_attr_stack_t *attr_stack = NULL;
 state_queue_t *states = NULL;
 token_queue_t *que = NULL;
 
+static void dom_tree_index_setup(dom_tree_t *tree, const int flags)
+{
+  tree->flags = flags;
+
+  if (tree->flags & DOM_TREE_INDEX_TAGS)
+  {
+    tree->index = dom_tag_index_new();
+  }
+
+  if (tree->flags & DOM_TREE_INDEX_ATTRS)
+  {
+    tree->ids = dom_attr_map_new(DOM_ATTR_MAP_CAPACITY);
+    tree->classes = dom_attr_map_new(DOM_ATTR_MAP_CAPACITY);
+  }
+}
+
 static void __html_parse_file(uint8_t *data, const ssize_t size)
 {
   (void)size;
@@ -135,6 +170,11 @@ dom_tree_t *html_parse_file(const char *filepath)
 }
 
 dom_tree_t *html_parse(void *data, const ssize_t size)
+{
+  return html_parse_ex(data, size, 0);
+}
+
+dom_tree_t *html_parse_ex(void *data, const ssize_t size, const int flags)
 {
   const char delim = '\n';
   dom_tree_t *tree = NULL;
@@ -154,6 +194,8 @@ dom_tree_t *html_parse(void *data, const ssize_t size)
   attr_stack = dom_tree_node_attr_stack_new(DOM_TREE_NODE_ATTR_STACK_CAPACITY);
   states = state_queue_new(STATE_QUEUE_CAPACITY);
 
+  dom_tree_index_setup(tree, flags);
+
   memset(&list, 0, sizeof(list));
 
   if (false == state_queue_enqueue_back(states, &__parse_tag_open))
@@ -189,6 +231,227 @@ dom_tree_t *html_parse(void *data, const ssize_t size)
 
   tree->root = dom_tree_node_stack_pop(stack);
   dom_tree_node_stack_destroy(stack);
+
+  // NOTE: The root is never closed by the parser, so it is indexed
+  //       once it comes off the stack.
+  if (tree->flags & DOM_TREE_INDEX_TAGS)
+  {
+    dom_tag_index_insert(tree->index, tree->root);
+  }
+  return tree;
+}
+
+dom_tree_t *html_parse_tokens(token_queue_t *que)
+{
+  dom_tree_t *tree = NULL;
+  dom_tree_node_stack_t *stack = NULL;
+  dom_tree_node_attr_stack_t *attr_stack = NULL;
+  state_queue_t *states = NULL;
+
+  tree = dom_tree_new();
+  stack = dom_tree_node_stack_new(DOM_TREE_NODE_STACK_CAPACITY);
+  attr_stack = dom_tree_node_attr_stack_new(DOM_TREE_NODE_ATTR_STACK_CAPACITY);
+  states = state_queue_new(STATE_QUEUE_CAPACITY);
+
+  if (false == state_queue_enqueue_back(states, &__parse_tag_open))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into state queue");
+    exit(EXIT_FAILURE);
+  }
+
+  __parse(tree, stack, attr_stack, states, que);
+
+  state_queue_destroy(states);
+  dom_tree_node_attr_stack_destroy(attr_stack);
+
+  if (1ul != stack->top)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+    exit(EXIT_FAILURE);
+  }
+
+  tree->root = dom_tree_node_stack_pop(stack);
+  dom_tree_node_stack_destroy(stack);
+  return tree;
+}
+
+dom_tree_t *html_parse_indexed(const void *data, const ssize_t size)
+{
+  return html_parse_indexed_ex(data, size, 0);
+}
+
+dom_tree_t *html_parse_indexed_ex(const void *data, const ssize_t size, const int flags)
+{
+  dom_tree_t *tree = NULL;
+  html_builder_t *builder = NULL;
+  html_scan_t *scan = NULL;
+
+  tree = dom_tree_new();
+  dom_tree_index_setup(tree, flags);
+  scan = html_scan(html_scan_new(HTML_SCAN_CAPACITY), data, size);
+  builder = html_builder_new(tree);
+
+  if (HTML_WALK_TEXT != html_builder_walk(builder, scan, data, size))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+    exit(EXIT_FAILURE);
+  }
+
+  tree->root = html_builder_finish(builder);
+
+  html_builder_destroy(builder);
+  html_scan_destroy(scan);
+  return tree;
+}
+
+static void html_parse_chunk(void *arg)
+{
+  html_chunk_t *chunk = (html_chunk_t *)arg;
+  html_scan_t *scan = NULL;
+
+  scan = html_scan(html_scan_new(HTML_SCAN_CAPACITY), chunk->data, chunk->size);
+  chunk->builder = html_builder_new_fragment();
+  chunk->state = html_builder_walk(chunk->builder, scan, chunk->data, chunk->size);
+  html_scan_destroy(scan);
+}
+
+/**
+ * @brief Find the first '<' at or after the offset that can start a
+ *        tag and follows a '>' or whitespace, which makes script text
+ *        an unlikely pick. Whether it really starts a tag is only known
+ *        once the preceding chunk has been walked.
+ */
+static size_t html_parse_split(const uint8_t *data, const size_t size, size_t i)
+{
+  const uint8_t *p = NULL;
+
+  while (i < size && NULL != (p = memchr(data + i, '<', size - i)))
+  {
+    i = (size_t)(p - data);
+    if ((i + 1ul) < size && (isalpha(data[i + 1ul]) || data[i + 1ul] == '/') &&
+        0ul < i && (data[i - 1ul] == '>' || isspace(data[i - 1ul])))
+    {
+      return i;
+    }
+    i++;
+  }
+
+  return size;
+}
+
+static int html_parse_walk(html_builder_t *builder, const uint8_t *data, const size_t size)
+{
+  static const html_walker_t probe = { NULL, NULL, NULL, NULL, NULL, NULL };
+  html_scan_t *scan = NULL;
+  int state;
+
+  scan = html_scan(html_scan_new(HTML_SCAN_CAPACITY), data, size);
+  if (builder == NULL)
+  {
+    state = html_walk(scan, data, size, &probe, NULL);
+  }
+  else
+  {
+    state = html_builder_walk(builder, scan, data, size);
+  }
+  html_scan_destroy(scan);
+  return state;
+}
+
+dom_tree_t *html_parse_parallel(const void *data, const ssize_t size, uint64_t nthreads)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  dom_tree_t *tree = NULL;
+  html_builder_t *builder = NULL;
+  html_chunk_t *chunks = NULL;
+  size_t start;
+  size_t end;
+  uint64_t n;
+  uint64_t i;
+  uint64_t j;
+  uint64_t k;
+  int state;
+
+  if (nthreads == 0ul)
+  {
+    nthreads = task_cpu_count();
+  }
+
+  n = (uint64_t)size / HTML_PARSE_CHUNK_MIN;
+  n = (n < 1ul) ? 1ul : (n > nthreads) ? nthreads : n;
+
+  chunks = (html_chunk_t *)calloc(n, sizeof(*chunks));
+  if (chunks == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (start = 0ul, i = 0ul, j = 0ul; j < n && start < (size_t)size; j++)
+  {
+    end = (j + 1ul == n) ? (size_t)size : html_parse_split(bytes, size, (((j + 1ul) * (size_t)size) / n));
+    if (end <= start)
+    {
+      continue;
+    }
+    chunks[i].data = bytes + start;
+    chunks[i].size = end - start;
+    start = end;
+    i++;
+  }
+  n = i;
+
+  task_run(&html_parse_chunk, chunks, sizeof(*chunks), n, nthreads);
+
+  tree = dom_tree_new();
+  builder = html_builder_new(tree);
+
+  for (i = 0ul; i < n; i++)
+  {
+    if (HTML_WALK_TEXT == chunks[i].state && !chunks[i].builder->failed)
+    {
+      html_builder_stitch(builder, chunks[i].builder);
+      continue;
+    }
+
+    // NOTE: The chunk ended inside a tag, comment or raw text, so the
+    //       next boundary was a guess that did not hold. Grow the range
+    //       until it ends between tags and build it sequentially.
+    start = (size_t)(chunks[i].data - bytes);
+    state = chunks[i].state;
+
+    for (j = i; HTML_WALK_TEXT != state && (j + 1ul) < n; )
+    {
+      j++;
+      end = (size_t)(chunks[j].data - bytes) + chunks[j].size;
+      state = html_parse_walk(NULL, bytes + start, end - start);
+    }
+
+    end = (size_t)(chunks[j].data - bytes) + chunks[j].size;
+
+    for (k = i; k <= j; k++)
+    {
+      html_builder_discard(chunks[k].builder);
+    }
+
+    if (HTML_WALK_TEXT != html_parse_walk(builder, bytes + start, end - start))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+      exit(EXIT_FAILURE);
+    }
+
+    i = j;
+  }
+
+  tree->root = html_builder_finish(builder);
+
+  for (i = 0ul; i < n; i++)
+  {
+    html_builder_destroy(chunks[i].builder);
+  }
+
+  html_builder_destroy(builder);
+  free(chunks);
   return tree;
 }
 
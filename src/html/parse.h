@@ -1,12 +1,48 @@
 #ifndef PARSE_H
 #define PARSE_H
 
+#include "token.h"
 #include "tree.h"
 
+#include <stdint.h>
 #include <sys/types.h>
 
 dom_tree_t *html_parse_file(const char *filepath);
 
+/**
+ * @brief Flags for the _ex parsers. With HTML_PARSE_INDEX_TAGS the
+ *        parser fills a tag index as it closes elements, which
+ *        dom_tree_get_elements_by_tag() then answers from. With
+ *        HTML_PARSE_INDEX_ATTRS it maps ids and class tokens to their
+ *        elements as attribute values complete, for
+ *        dom_tree_get_element_by_id() and dom_tree_get_elements_by_class().
+ */
+#define HTML_PARSE_INDEX_TAGS  DOM_TREE_INDEX_TAGS
+#define HTML_PARSE_INDEX_ATTRS DOM_TREE_INDEX_ATTRS
+
 dom_tree_t *html_parse(void *data, const ssize_t size);
 
+dom_tree_t *html_parse_ex(void *data, const ssize_t size, const int flags);
+
+/**
+ * @brief Run the parser state machine over a complete token stream,
+ *        such as the one produced by lex_parallel().
+ */
+dom_tree_t *html_parse_tokens(token_queue_t *que);
+
+/**
+ * @brief Parse in two stages: scan the whole buffer for structural
+ *        characters, then build the tree by walking only those.
+ */
+dom_tree_t *html_parse_indexed(const void *data, const ssize_t size);
+
+dom_tree_t *html_parse_indexed_ex(const void *data, const ssize_t size, const int flags);
+
+/**
+ * @brief Parse a large buffer by splitting it at tag boundaries and
+ *        building each chunk on its own thread. A zero thread count
+ *        means one per online processor.
+ */
+dom_tree_t *html_parse_parallel(const void *data, const ssize_t size, uint64_t nthreads);
+
 #endif/*PARSE_H*/
@@ -10,6 +10,7 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "html/attrmap.h"
 #include "html/node.h"
 #include "html/state.h"
 #include "html/tree.h"
@@ -23,15 +24,28 @@ int __parse_attribute_name(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_t
 
 static int __parse_next_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_node_attr_stack_t *attr_stack, state_queue_t *states, token_queue_t *que);
 
+/**
+ * @brief The closing quote finalizes the value; index it before the
+ *        attribute leaves the stack.
+ */
+static void __parse_attribute_finish(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_node_attr_stack_t *attr_stack)
+{
+  dom_tree_node_attr_t *attr = NULL;
+
+  attr = dom_tree_node_attr_stack_pop(attr_stack);
+
+  if (attr != NULL && (tree->flags & DOM_TREE_INDEX_ATTRS))
+  {
+    dom_attr_map_index(tree->ids, tree->classes, dom_tree_node_stack_peek(stack), attr);
+  }
+}
+
 int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_node_attr_stack_t *attr_stack, state_queue_t *states, token_queue_t *que)
 {
   dom_tree_node_attr_t *attr = NULL;
   token_t *curr = NULL;
   token_t *next = NULL;
 
-  (void)tree;
-  (void)stack;
-
   attr = dom_tree_node_attr_stack_peek(attr_stack);
   if (attr == NULL)
   {
@@ -51,7 +65,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
   switch (curr->kind)
   {
     case KIND_COLON:
-      if (false == dom_tree_node_attr_append_value(attr, ":", 2ul))
+      if (false == dom_tree_node_attr_append_value(attr, ":", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -59,7 +73,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_DASH:
-      if (false == dom_tree_node_attr_append_value(attr, "-", 2ul))
+      if (false == dom_tree_node_attr_append_value(attr, "-", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -67,7 +81,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_PERIOD:
-      if (false == dom_tree_node_attr_append_value(attr, ".", 2ul))
+      if (false == dom_tree_node_attr_append_value(attr, ".", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -75,7 +89,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_FWD_SLASH:
-      if (false == dom_tree_node_attr_append_value(attr, "/", 2ul))
+      if (false == dom_tree_node_attr_append_value(attr, "/", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -83,7 +97,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_UNDERSCORE:
-      if (false == dom_tree_node_attr_append_value(attr, "/", 2ul))
+      if (false == dom_tree_node_attr_append_value(attr, "_", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -91,7 +105,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_WORD:
-      if (false == dom_tree_node_attr_append_value(attr, curr->data, curr->size))
+      if (false == dom_tree_node_attr_append_value(attr, curr->data, curr->size - 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -99,7 +113,15 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_NUMBER:
-      if (false == dom_tree_node_attr_append_value(attr, curr->data, curr->size))
+      if (false == dom_tree_node_attr_append_value(attr, curr->data, curr->size - 1ul))
+      {
+        fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+    case KIND_SPACE:
+      if (false == dom_tree_node_attr_append_value(attr, " ", 1ul))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not write into node body");
         exit(EXIT_FAILURE);
@@ -133,6 +155,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
     case KIND_WORD:
     case KIND_DASH:
     case KIND_NUMBER:
+    case KIND_SPACE:
       if (false == state_queue_enqueue_back(states, &__parse_attribute_value))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into state queue");
@@ -141,7 +164,7 @@ int __parse_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_
       break;
 
     case KIND_DBL_QUOT:
-      dom_tree_node_attr_stack_pop(attr_stack);
+      __parse_attribute_finish(tree, stack, attr_stack);
       if (false == state_queue_enqueue_back(states, &__parse_attribute_name))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into state queue");
@@ -161,10 +184,6 @@ static int __parse_next_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t
 {
   token_t *next = NULL;
 
-  (void)tree;
-  (void)stack;
-  (void)attr_stack;
-
   next = token_queue_peek(que);
 
   if (next == NULL)
@@ -182,6 +201,7 @@ static int __parse_next_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t
     case KIND_WORD:
     case KIND_DASH:
     case KIND_NUMBER:
+    case KIND_SPACE:
       if (false == state_queue_enqueue_back(states, &__parse_attribute_value))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into state queue");
@@ -190,7 +210,7 @@ static int __parse_next_attribute_value(dom_tree_t *tree, dom_tree_node_stack_t
       break;
 
     case KIND_DBL_QUOT:
-      dom_tree_node_attr_stack_pop(attr_stack);
+      __parse_attribute_finish(tree, stack, attr_stack);
       if (false == state_queue_enqueue_back(states, &__parse_attribute_name))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into state queue");
@@ -12,6 +12,7 @@
  */
 #include "html/node.h"
 #include "html/state.h"
+#include "html/tag.h"
 #include "html/tree.h"
 #include "token.h"
 
@@ -30,7 +31,6 @@ int __parse_elm_close(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_n
   token_t *curr = NULL;
   token_t *next = NULL;
 
-  (void)tree;
   (void)attr_stack;
 
   curr = token_queue_dequeue(que);
@@ -67,6 +67,10 @@ int __parse_elm_close(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_n
             exit(EXIT_FAILURE);
           }
         }
+        if (tree->flags & DOM_TREE_INDEX_TAGS)
+        {
+          dom_tag_index_insert(tree->index, node);
+        }
       }
       break;
 
@@ -26,10 +26,10 @@ static int __parse_next_tag_open(dom_tree_t *tree, dom_tree_node_stack_t *stack,
 
 int __parse_tag_open(dom_tree_t *tree, dom_tree_node_stack_t *stack, dom_tree_node_attr_stack_t *attr_stack, state_queue_t *states, token_queue_t *que)
 {
+  dom_tree_node_t *node = NULL;
   token_t *curr = NULL;
   token_t *next = NULL;
 
-  (void)tree;
   (void)attr_stack;
 
   curr = token_queue_dequeue(que);
@@ -71,7 +71,9 @@ skip:
   switch (curr->kind)
   {
     case KIND_LT_CARET:
-      if (false == dom_tree_node_stack_push(stack, dom_tree_node_new(NULL, NULL, DOM_TREE_NODE_DEFAULT_CAPACITY)))
+      node = dom_tree_node_new(NULL, NULL, DOM_TREE_NODE_DEFAULT_CAPACITY);
+      node->pre = tree->count++;
+      if (false == dom_tree_node_stack_push(stack, node))
       {
         fprintf(stderr, "%s(): %s\n", __func__, "could not push node onto node stack");
         exit(EXIT_FAILURE);
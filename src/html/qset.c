@@ -0,0 +1,301 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "bloom.h"
+#include "css.h"
+#include "mem.h"
+#include "node.h"
+#include "qset.h"
+#include "trav.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct css_qset_visit
+{
+  css_qset_t *set;
+  const dom_bloom_t *bloom;
+  dom_tree_node_t *node;
+};
+
+typedef struct css_qset_visit css_qset_visit_t;
+
+css_qset_t *css_qset_new(void)
+{
+  css_qset_t *self = NULL;
+  self = (css_qset_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->dirty = true;
+  self->cap = self->entcap = CSS_QSET_CAPACITY;
+  self->progs = (css_prog_t **)malloc(self->cap * sizeof(*self->progs));
+  self->results = (dom_tree_node_list_t **)malloc(self->cap * sizeof(*self->results));
+  self->entries = (css_qset_entry_t *)malloc(self->entcap * sizeof(*self->entries));
+  if (self->progs == NULL || self->results == NULL || self->entries == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void css_qset_destroy(css_qset_t *self)
+{
+  uint64_t i;
+
+  if (self != NULL)
+  {
+    for (i = 0ul; i < self->count; i++)
+    {
+      css_prog_destroy(self->progs[i]);
+      dom_tree_node_list_destroy(self->results[i]);
+    }
+
+    free(self->progs);
+    free(self->results);
+    free(self->entries);
+    free(self->slots);
+    free(self);
+    self = NULL;
+  }
+}
+
+static void css_qset_file(css_qset_t *self, const uint32_t query, const css_prog_t *prog, const uint64_t pc)
+{
+  const css_inst_t *inst = prog->insts + pc;
+  css_qset_entry_t *entry = NULL;
+
+  if (self->nent >= self->entcap)
+  {
+    self->entcap <<= 1;
+    self->entries = (css_qset_entry_t *)mem_grow(self->entries, self->entcap * sizeof(*self->entries));
+  }
+
+  entry = self->entries + self->nent++;
+  entry->query = query;
+  entry->pc = pc;
+
+  // NOTE: The tests of a compound are ordered from the most selective,
+  //       so the first one is the best key when it is hashed at all.
+  switch (inst->op)
+  {
+    case CSS_OP_ID:
+    case CSS_OP_TYPE:
+    case CSS_OP_CLASS:
+      entry->any = false;
+      entry->hash = inst->hash;
+      break;
+
+    default:
+      entry->any = true;
+      entry->hash = 0u;
+      break;
+  }
+}
+
+int64_t css_qset_add(css_qset_t *self, const char *selector)
+{
+  css_prog_t *prog = NULL;
+  uint64_t i;
+
+  prog = css_compile(selector);
+  if (prog == NULL)
+  {
+    return -1;
+  }
+
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->progs = (css_prog_t **)mem_grow(self->progs, self->cap * sizeof(*self->progs));
+    self->results = (dom_tree_node_list_t **)mem_grow(self->results, self->cap * sizeof(*self->results));
+  }
+
+  self->progs[self->count] = prog;
+  self->results[self->count] = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+
+  for (i = 0ul; i < prog->nsel; i++)
+  {
+    css_qset_file(self, (uint32_t)self->count, prog, prog->starts[i]);
+  }
+
+  self->ancestors = self->ancestors || css_tests_ancestors(prog);
+  self->dirty = true;
+  return (int64_t)self->count++;
+}
+
+static int css_qset_entry_cmp(const void *a, const void *b)
+{
+  const css_qset_entry_t *x = (const css_qset_entry_t *)a;
+  const css_qset_entry_t *y = (const css_qset_entry_t *)b;
+
+  if (x->any != y->any)
+  {
+    return x->any ? -1 : 1;
+  }
+  if (x->hash != y->hash)
+  {
+    return (x->hash < y->hash) ? -1 : 1;
+  }
+  if (x->query != y->query)
+  {
+    return (x->query < y->query) ? -1 : 1;
+  }
+  return (x->pc < y->pc) ? -1 : (x->pc > y->pc);
+}
+
+/**
+ * @brief Return the slot of the hash, which is empty when no entry has
+ *        it. Slots hold an entry index plus one.
+ */
+static uint64_t *css_qset_probe(const css_qset_t *self, const uint32_t hash)
+{
+  const uint64_t mask = self->slotcap - 1ul;
+  uint64_t i;
+
+  for (i = hash & mask; self->slots[i] != 0ul; i = (i + 1ul) & mask)
+  {
+    if (self->entries[self->slots[i] - 1ul].hash == hash)
+    {
+      break;
+    }
+  }
+
+  return self->slots + i;
+}
+
+/**
+ * @brief Sort the entries and index the keyed ones by hash.
+ */
+static void css_qset_build(css_qset_t *self)
+{
+  uint64_t *slot = NULL;
+  uint64_t i;
+
+  qsort(self->entries, self->nent, sizeof(*self->entries), &css_qset_entry_cmp);
+
+  for (self->nany = 0ul; self->nany < self->nent && self->entries[self->nany].any; self->nany++);
+
+  for (self->slotcap = CSS_QSET_SLOTS_CAPACITY; self->slotcap < (self->nent << 1); self->slotcap <<= 1);
+
+  free(self->slots);
+  self->slots = (uint64_t *)calloc(self->slotcap, sizeof(*self->slots));
+  if (self->slots == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = self->nany; i < self->nent; i++)
+  {
+    slot = css_qset_probe(self, self->entries[i].hash);
+    if (*slot == 0ul)
+    {
+      *slot = i + 1ul;
+    }
+  }
+
+  self->dirty = false;
+}
+
+static void css_qset_try(css_qset_visit_t *visit, const css_qset_entry_t *entry)
+{
+  css_qset_t *set = visit->set;
+  dom_tree_node_list_t *list = set->results[entry->query];
+
+  // NOTE: A query matches an element once, however many of its
+  //       selectors or of the element's keys lead to it.
+  if (0ul < list->count && list->nodes[list->count - 1ul] == visit->node)
+  {
+    return;
+  }
+
+  if (css_reject(set->progs[entry->query], entry->pc, visit->bloom) ||
+      !css_run(set->progs[entry->query], entry->pc, visit->node))
+  {
+    return;
+  }
+
+  set->results[entry->query] = dom_tree_node_list_append(list, visit->node);
+}
+
+static void css_qset_key(void *ctx, const uint32_t hash)
+{
+  css_qset_visit_t *visit = (css_qset_visit_t *)ctx;
+  const css_qset_t *set = visit->set;
+  uint64_t i;
+
+  i = *css_qset_probe(set, hash);
+  if (i == 0ul)
+  {
+    return;
+  }
+
+  for (i -= 1ul; i < set->nent && set->entries[i].hash == hash; i++)
+  {
+    css_qset_try(visit, set->entries + i);
+  }
+}
+
+void css_qset_select(css_qset_t *self, const dom_tree_t *tree)
+{
+  css_qset_visit_t visit;
+  dom_trav_t *trav = NULL;
+  uint64_t i;
+
+  if (self->dirty)
+  {
+    css_qset_build(self);
+  }
+
+  for (i = 0ul; i < self->count; i++)
+  {
+    self->results[i]->count = 0ul;
+  }
+
+  trav = dom_trav_new(DOM_TRAV_PREORDER);
+  if (self->ancestors)
+  {
+    dom_trav_track_ancestors(trav);
+  }
+  dom_trav_reset(trav, tree->root);
+
+  visit.set = self;
+  visit.bloom = trav->bloom;
+
+  while (NULL != (visit.node = dom_trav_next(trav)))
+  {
+    for (i = 0ul; i < self->nany; i++)
+    {
+      css_qset_try(&visit, self->entries + i);
+    }
+
+    dom_bloom_node_keys(visit.node, &css_qset_key, &visit);
+  }
+
+  dom_trav_destroy(trav);
+}
+
+const dom_tree_node_list_t *css_qset_results(const css_qset_t *self, const int64_t query)
+{
+  return self->results[query];
+}
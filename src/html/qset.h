@@ -0,0 +1,79 @@
+#ifndef QSET_H
+#define QSET_H
+
+#include "css.h"
+#include "node.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CSS_QSET_CAPACITY       (1ul << 4)
+#define CSS_QSET_SLOTS_CAPACITY (1ul << 6)
+
+/**
+ * @brief One selector of one query, filed under the key its rightmost
+ *        compound tests first: a type, id or class hash, or none when
+ *        it has no such test and every element is a candidate.
+ */
+struct css_qset_entry
+{
+  bool any;
+  uint32_t hash;
+  uint32_t query;
+  uint64_t pc;
+};
+
+typedef struct css_qset_entry css_qset_entry_t;
+
+/**
+ * @brief A set of queries compiled for evaluation in one walk. The
+ *        keyed entries are sorted by hash after the keyless ones, and
+ *        'slots' is an open addressing table from a hash to the first
+ *        entry with it, so an element only runs the selectors that can
+ *        match its own tag, id or classes.
+ */
+struct css_qset
+{
+  size_t cap;
+  uint64_t count;
+  css_prog_t **progs;
+  dom_tree_node_list_t **results;
+  size_t entcap;
+  uint64_t nent;
+  uint64_t nany;
+  css_qset_entry_t *entries;
+  size_t slotcap;
+  uint64_t *slots;
+  bool ancestors;
+  bool dirty;
+};
+
+typedef struct css_qset css_qset_t;
+
+css_qset_t *css_qset_new(void);
+
+void css_qset_destroy(css_qset_t *self);
+
+/**
+ * @brief Add a query given as a selector list. A tag query is a type
+ *        selector and an attribute query an attribute selector. Returns
+ *        the query id, counting from zero, or -1 when the selector is
+ *        malformed.
+ */
+int64_t css_qset_add(css_qset_t *self, const char *selector);
+
+/**
+ * @brief Evaluate every query in one depth first walk of the tree. The
+ *        matches of each query are then read with css_qset_results().
+ */
+void css_qset_select(css_qset_t *self, const dom_tree_t *tree);
+
+/**
+ * @brief The elements the query matched in the last walk, in document
+ *        order. The list belongs to the set.
+ */
+const dom_tree_node_list_t *css_qset_results(const css_qset_t *self, const int64_t query);
+
+#endif/*QSET_H*/
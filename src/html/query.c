@@ -10,44 +10,139 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "attrmap.h"
+#include "query.h"
+#include "tag.h"
+#include "trav.h"
 #include "tree.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
-static dom_tree_node_t *__dom_tree_get_element_by_name(const dom_tree_node_t *self, const char *name)
+dom_tree_node_t *dom_tree_get_element_by_name(const dom_tree_t *self, const char *name)
 {
-  if (self == NULL)
-  {
-    return NULL;
-  }
+  dom_trav_t *trav = NULL;
+  dom_tree_node_t *node = NULL;
+
+  trav = dom_trav_new(DOM_TRAV_PREORDER);
+  dom_trav_reset(trav, self->root);
 
+  while (NULL != (node = dom_trav_next(trav)) && 0 != strcmp(node->name, name));
+
+  dom_trav_destroy(trav);
+  return node;
+}
+
+void dom_tree_number(dom_tree_t *self)
+{
+  dom_trav_t *trav = NULL;
   dom_tree_node_t *node = NULL;
-  uint64_t i;
+  uint64_t post = 0ul;
 
-  if (0 == strcmp(self->name, name))
-  {
-    return (dom_tree_node_t *)self;
-  }
+  dom_tree_node_list_destroy(self->nodes);
+  self->nodes = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+  self->count = 0ul;
+
+  trav = dom_trav_new(DOM_TRAV_EULER);
+  dom_trav_reset(trav, self->root);
 
-  for (i = 0ul; i < self->count; i++)
+  while (NULL != (node = dom_trav_next(trav)))
   {
-    if (self->children[i] == NULL)
+    if (trav->leave)
     {
+      node->post = post++;
       continue;
     }
 
-    node = __dom_tree_get_element_by_name(self->children[i], name);
-    if (node != NULL)
+    node->pre = self->count++;
+    node->depth = trav->depth;
+    self->nodes = dom_tree_node_list_append(self->nodes, node);
+  }
+
+  dom_trav_destroy(trav);
+}
+
+dom_tree_node_t **dom_tree_get_descendants(const dom_tree_t *self, const dom_tree_node_t *node, uint64_t *n)
+{
+  *n = dom_tree_node_descendants(node);
+  return self->nodes->nodes + node->pre + 1ul;
+}
+
+void dom_tree_index_build(dom_tree_t *self)
+{
+  dom_tree_node_t *node = NULL;
+  uint64_t i;
+  uint64_t j;
+
+  dom_tag_index_destroy(self->index);
+  dom_attr_map_destroy(self->ids);
+  dom_attr_map_destroy(self->classes);
+
+  self->index = dom_tag_index_new();
+  self->ids = dom_attr_map_new(DOM_ATTR_MAP_CAPACITY);
+  self->classes = dom_attr_map_new(DOM_ATTR_MAP_CAPACITY);
+  self->flags |= DOM_TREE_INDEX_TAGS | DOM_TREE_INDEX_ATTRS;
+
+  dom_tree_number(self);
+
+  for (i = 0ul; i < self->nodes->count; i++)
+  {
+    node = self->nodes->nodes[i];
+    dom_tag_index_insert(self->index, node);
+
+    for (j = 0ul; j < node->attrs_count; j++)
     {
-      break;
+      dom_attr_map_index(self->ids, self->classes, node, node->attrs[j]);
     }
   }
+}
 
-  return node;
+dom_tree_node_t **dom_tree_get_elements_by_tag(const dom_tree_t *self, const char *tag, uint64_t *n)
+{
+  dom_tree_node_list_t *list = NULL;
+  uint32_t id;
+
+  *n = 0ul;
+
+  if (self->index == NULL)
+  {
+    return NULL;
+  }
+
+  id = dom_tag_index_id(self->index, tag, strlen(tag), false);
+  if (id == DOM_TAG_UNKNOWN || NULL == (list = self->index->lists[id]))
+  {
+    return NULL;
+  }
+
+  *n = list->count;
+  return list->nodes;
 }
 
-dom_tree_node_t *dom_tree_get_element_by_name(const dom_tree_t *self, const char *name)
+dom_tree_node_t *dom_tree_get_element_by_id(const dom_tree_t *self, const char *id)
 {
-  return __dom_tree_get_element_by_name(self->root, name);
+  dom_tree_node_list_t *list = NULL;
+
+  if (self->ids == NULL || NULL == (list = dom_attr_map_get(self->ids, id, strlen(id))))
+  {
+    return NULL;
+  }
+
+  return list->nodes[0];
+}
+
+dom_tree_node_t **dom_tree_get_elements_by_class(const dom_tree_t *self, const char *name, uint64_t *n)
+{
+  dom_tree_node_list_t *list = NULL;
+
+  *n = 0ul;
+
+  if (self->classes == NULL || NULL == (list = dom_attr_map_get(self->classes, name, strlen(name))))
+  {
+    return NULL;
+  }
+
+  *n = list->count;
+  return list->nodes;
 }
@@ -3,6 +3,48 @@
 
 #include "tree.h"
 
+#include <stdint.h>
+
 dom_tree_node_t *dom_tree_get_element_by_name(const dom_tree_t *self, const char *name);
 
+/**
+ * @brief Give every element its preorder and postorder numbers and its
+ *        depth, and list the elements in document order in 'nodes', so
+ *        an element's descendants are the 'nodes' entries that follow it.
+ */
+void dom_tree_number(dom_tree_t *self);
+
+/**
+ * @brief Return the descendants of a numbered element as a range of the
+ *        tree's document order array, setting 'n' to its length.
+ */
+dom_tree_node_t **dom_tree_get_descendants(const dom_tree_t *self, const dom_tree_node_t *node, uint64_t *n);
+
+/**
+ * @brief Number the elements in document order and build the tag, id
+ *        and class indexes of a tree whose parser did not, such as
+ *        html_parse_parallel().
+ */
+void dom_tree_index_build(dom_tree_t *self);
+
+/**
+ * @brief Return every element with the tag, in document order, from the
+ *        tree's tag index. The array belongs to the index and 'n' is set
+ *        to its length; NULL is returned when there is no match or the
+ *        tree was not indexed.
+ */
+dom_tree_node_t **dom_tree_get_elements_by_tag(const dom_tree_t *self, const char *tag, uint64_t *n);
+
+/**
+ * @brief Return the first element with the id from the tree's id index,
+ *        or NULL.
+ */
+dom_tree_node_t *dom_tree_get_element_by_id(const dom_tree_t *self, const char *id);
+
+/**
+ * @brief Return every element with the class, in document order, from
+ *        the tree's class index, as for dom_tree_get_elements_by_tag().
+ */
+dom_tree_node_t **dom_tree_get_elements_by_class(const dom_tree_t *self, const char *name, uint64_t *n);
+
 #endif/*QUERY_H*/
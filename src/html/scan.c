@@ -0,0 +1,184 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "scan.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define HTML_SCAN_BLOCK 64ul
+
+static void html_scan_setup(html_scan_t *self, const size_t cap)
+{
+  self->cap = cap;
+  self->count = 0ul;
+}
+
+html_scan_t *html_scan_new(const size_t cap)
+{
+  const size_t size = offsetof(html_scan_t, pos[cap]);
+  html_scan_t *self = NULL;
+  self = (html_scan_t *)malloc(size);
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  html_scan_setup(self, cap);
+  return self;
+}
+
+void html_scan_destroy(html_scan_t *self)
+{
+  if (self != NULL)
+  {
+    free(self);
+    self = NULL;
+  }
+}
+
+static html_scan_t *html_scan_reserve(html_scan_t *self, const size_t n)
+{
+  if ((self->count + n) <= self->cap)
+  {
+    return self;
+  }
+
+  size_t cap = self->cap;
+
+  while (cap < (self->count + n))
+  {
+    cap <<= 1;
+  }
+
+  void *__old = self;
+  self = NULL;
+  self = (html_scan_t *)realloc(__old, offsetof(html_scan_t, pos[cap]));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  self->cap = cap;
+  return self;
+}
+
+/**
+ * @brief Classify one 64 byte block, returning a bitmap with a bit set
+ *        for every structural character.
+ */
+static uint64_t html_scan_block(const uint8_t *block)
+{
+#if defined(__SSE2__)
+  const __m128i lt = _mm_set1_epi8('<');
+  const __m128i gt = _mm_set1_epi8('>');
+  const __m128i eq = _mm_set1_epi8('=');
+  const __m128i qt = _mm_set1_epi8('"');
+  uint64_t mask = 0ul;
+  uint64_t i;
+
+  for (i = 0ul; i < HTML_SCAN_BLOCK; i += 16ul)
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+    const __m128i m = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, lt), _mm_cmpeq_epi8(v, gt)),
+      _mm_or_si128(_mm_cmpeq_epi8(v, eq), _mm_cmpeq_epi8(v, qt)));
+    mask |= ((uint64_t)(uint16_t)_mm_movemask_epi8(m)) << i;
+  }
+
+  return mask;
+#else
+  uint64_t mask = 0ul;
+  uint64_t i;
+
+  for (i = 0ul; i < HTML_SCAN_BLOCK; i++)
+  {
+    switch (block[i])
+    {
+      case '<':
+      case '>':
+      case '=':
+      case '"':
+        mask |= (1ul << i);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return mask;
+#endif
+}
+
+/**
+ * @brief Flatten a block bitmap into the position array.
+ */
+static void html_scan_flatten(html_scan_t *self, const uint32_t base, uint64_t mask)
+{
+  uint32_t *out = self->pos + self->count;
+
+  self->count += (uint64_t)__builtin_popcountll(mask);
+
+  while (mask != 0ul)
+  {
+    *out++ = base + (uint32_t)__builtin_ctzll(mask);
+    mask &= mask - 1ul;
+  }
+}
+
+html_scan_t *html_scan(html_scan_t *self, const uint8_t *data, const size_t size)
+{
+  uint8_t tail[HTML_SCAN_BLOCK];
+  uint64_t mask;
+  size_t i;
+
+  if (size > UINT32_MAX)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "input too large for structural index");
+    exit(EXIT_FAILURE);
+  }
+
+  self->count = 0ul;
+
+  for (i = 0ul; (i + HTML_SCAN_BLOCK) <= size; i += HTML_SCAN_BLOCK)
+  {
+    mask = html_scan_block(data + i);
+    if (mask == 0ul)
+    {
+      continue;
+    }
+    self = html_scan_reserve(self, HTML_SCAN_BLOCK);
+    html_scan_flatten(self, (uint32_t)i, mask);
+  }
+
+  if (i < size)
+  {
+    memset(tail, 0, HTML_SCAN_BLOCK * sizeof(*tail));
+    memcpy(tail, data + i, size - i);
+    mask = html_scan_block(tail);
+    if (mask != 0ul)
+    {
+      self = html_scan_reserve(self, HTML_SCAN_BLOCK);
+      html_scan_flatten(self, (uint32_t)i, mask);
+    }
+  }
+
+  return self;
+}
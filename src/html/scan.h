@@ -0,0 +1,28 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTML_SCAN_CAPACITY (1ul << 10)
+
+/**
+ * @brief Structural index produced by the first parse stage. Each entry
+ *        is the byte offset of a '<', '>', '=' or '"' in the input.
+ */
+struct html_scan
+{
+  size_t cap;
+  uint64_t count;
+  uint32_t pos[];
+};
+
+typedef struct html_scan html_scan_t;
+
+html_scan_t *html_scan_new(const size_t cap);
+
+void html_scan_destroy(html_scan_t *self);
+
+html_scan_t *html_scan(html_scan_t *self, const uint8_t *data, const size_t size);
+
+#endif/*SCAN_H*/
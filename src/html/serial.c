@@ -0,0 +1,261 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "node.h"
+#include "serial.h"
+#include "trav.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const dom_raw_tags[] = {
+  "script", "style", NULL,
+};
+
+dom_buffer_t *dom_buffer_new(const size_t cap)
+{
+  return dom_buffer_new_sink(cap, NULL, NULL);
+}
+
+dom_buffer_t *dom_buffer_new_sink(const size_t cap, dom_sink_t sink, void *ctx)
+{
+  dom_buffer_t *self = NULL;
+  self = (dom_buffer_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = (cap < 1ul) ? 1ul : cap;
+  self->sink = sink;
+  self->ctx = ctx;
+  self->data = (uint8_t *)malloc(self->cap * sizeof(*self->data));
+  if (self->data == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_buffer_destroy(dom_buffer_t *self)
+{
+  if (self != NULL)
+  {
+    dom_buffer_flush(self);
+
+    if (self->data != NULL)
+    {
+      free(self->data);
+      self->data = NULL;
+    }
+
+    free(self);
+    self = NULL;
+  }
+}
+
+static void dom_buffer_drain(dom_buffer_t *self, const void *data, const size_t size)
+{
+  if (size != self->sink(self->ctx, data, size))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not write to sink");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void dom_buffer_flush(dom_buffer_t *self)
+{
+  if (self->sink != NULL && 0ul < self->size)
+  {
+    dom_buffer_drain(self, self->data, self->size);
+    self->size = 0ul;
+  }
+}
+
+void dom_buffer_write(dom_buffer_t *self, const void *data, const size_t size)
+{
+  if ((self->size + size) > self->cap)
+  {
+    if (self->sink != NULL)
+    {
+      dom_buffer_flush(self);
+
+      // NOTE: Anything at least as large as the buffer goes straight
+      //       to the sink rather than being copied through it.
+      if (size >= self->cap)
+      {
+        dom_buffer_drain(self, data, size);
+        return;
+      }
+    }
+    else
+    {
+      while ((self->size + size) > self->cap)
+      {
+        self->cap <<= 1;
+      }
+
+      void *__old = self->data;
+      self->data = NULL;
+      self->data = (uint8_t *)realloc(__old, self->cap * sizeof(*self->data));
+      if (self->data == NULL)
+      {
+        fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+  memcpy(self->data + self->size, data, size);
+  self->size += size;
+}
+
+size_t dom_buffer_fwrite(void *ctx, const void *data, const size_t size)
+{
+  return fwrite(data, sizeof(uint8_t), size, (FILE *)ctx);
+}
+
+/**
+ * @brief Copy the runs between occurrences of 'ch' in bulk, writing the
+ *        entity in place of each occurrence.
+ */
+static void dom_buffer_write_escaped(dom_buffer_t *self, const uint8_t *data, size_t size, const int ch, const char *entity, const size_t len)
+{
+  const uint8_t *p = NULL;
+
+  while (NULL != (p = memchr(data, ch, size)))
+  {
+    dom_buffer_write(self, data, (size_t)(p - data));
+    dom_buffer_write(self, entity, len);
+    size -= (size_t)(p - data) + 1ul;
+    data = p + 1;
+  }
+
+  dom_buffer_write(self, data, size);
+}
+
+void dom_buffer_write_text(dom_buffer_t *self, const void *data, const size_t size)
+{
+  dom_buffer_write_escaped(self, (const uint8_t *)data, size, '<', "&lt;", 4ul);
+}
+
+void dom_buffer_write_value(dom_buffer_t *self, const void *data, const size_t size)
+{
+  dom_buffer_write_escaped(self, (const uint8_t *)data, size, '"', "&quot;", 6ul);
+}
+
+bool dom_serialize_is_raw(const char *name, const size_t size)
+{
+  const char *const *tag = NULL;
+
+  for (tag = dom_raw_tags; *tag != NULL; tag++)
+  {
+    if (size == strlen(*tag) && 0 == memcmp(name, *tag, size))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void dom_serialize_open(const dom_tree_node_t *node, dom_buffer_t *sink)
+{
+  const dom_tree_node_attr_t *attr = NULL;
+  uint64_t i;
+
+  dom_buffer_write(sink, "<", 1ul);
+  dom_buffer_write(sink, node->name, node->namelen);
+
+  for (i = 0ul; i < node->attrs_count; i++)
+  {
+    attr = node->attrs[i];
+
+    dom_buffer_write(sink, " ", 1ul);
+    dom_buffer_write(sink, attr->name, strlen(attr->name));
+    dom_buffer_write(sink, "=\"", 2ul);
+
+    if (attr->value != NULL)
+    {
+      dom_buffer_write_value(sink, attr->value, attr->vallen);
+    }
+
+    dom_buffer_write(sink, "\"", 1ul);
+  }
+
+  dom_buffer_write(sink, ">", 1ul);
+
+  // NOTE: Entity references are kept verbatim in node bodies, so only
+  //       the characters that would change the parse are escaped, and
+  //       raw text elements are written untouched.
+  if (node->body != NULL)
+  {
+    if (dom_serialize_is_raw(node->name, node->namelen))
+    {
+      dom_buffer_write(sink, node->body, node->bodylen);
+    }
+    else
+    {
+      dom_buffer_write_text(sink, node->body, node->bodylen);
+    }
+  }
+}
+
+static void dom_serialize_close(const dom_tree_node_t *node, dom_buffer_t *sink)
+{
+  dom_buffer_write(sink, "</", 2ul);
+  dom_buffer_write(sink, node->name, node->namelen);
+  dom_buffer_write(sink, ">", 1ul);
+}
+
+void dom_tree_node_serialize(const dom_tree_node_t *node, dom_buffer_t *sink)
+{
+  dom_trav_t *trav = NULL;
+
+  if (node == NULL)
+  {
+    return;
+  }
+
+  trav = dom_trav_new(DOM_TRAV_EULER);
+  dom_trav_reset(trav, node);
+
+  while (NULL != (node = dom_trav_next(trav)))
+  {
+    if (trav->leave)
+    {
+      dom_serialize_close(node, sink);
+    }
+    else
+    {
+      dom_serialize_open(node, sink);
+    }
+  }
+
+  dom_trav_destroy(trav);
+}
+
+void dom_tree_serialize(const dom_tree_t *tree, dom_buffer_t *sink)
+{
+  dom_buffer_write(sink, "<!", 2ul);
+  dom_buffer_write(sink, tree->doctype, strlen(tree->doctype));
+  dom_buffer_write(sink, ">", 1ul);
+  dom_tree_node_serialize(tree->root, sink);
+}
@@ -0,0 +1,74 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "node.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_BUFFER_CAPACITY (1ul << 16)
+
+/**
+ * @brief Output callback used to drain a buffer. Returns the number of
+ *        bytes written.
+ */
+typedef size_t (*dom_sink_t)(void *ctx, const void *data, const size_t size);
+
+/**
+ * @brief Output buffer for serialized documents. Without a sink the
+ *        buffer grows to hold everything written; with one it is
+ *        drained through the sink whenever it fills up.
+ */
+struct dom_buffer
+{
+  size_t cap;
+  uint64_t size;
+  dom_sink_t sink;
+  void *ctx;
+  uint8_t *data;
+};
+
+typedef struct dom_buffer dom_buffer_t;
+
+dom_buffer_t *dom_buffer_new(const size_t cap);
+
+dom_buffer_t *dom_buffer_new_sink(const size_t cap, dom_sink_t sink, void *ctx);
+
+/**
+ * @brief Flush any pending output and release the buffer.
+ */
+void dom_buffer_destroy(dom_buffer_t *self);
+
+void dom_buffer_write(dom_buffer_t *self, const void *data, const size_t size);
+
+void dom_buffer_flush(dom_buffer_t *self);
+
+/**
+ * @brief Sink writing to the FILE passed as the context.
+ */
+size_t dom_buffer_fwrite(void *ctx, const void *data, const size_t size);
+
+/**
+ * @brief Write text, escaping any '<' so it cannot open a tag.
+ */
+void dom_buffer_write_text(dom_buffer_t *self, const void *data, const size_t size);
+
+/**
+ * @brief Write an attribute value, escaping any '"' so it cannot end
+ *        the quoted value.
+ */
+void dom_buffer_write_value(dom_buffer_t *self, const void *data, const size_t size);
+
+/**
+ * @brief Whether the element holds raw text, which is written without
+ *        escaping.
+ */
+bool dom_serialize_is_raw(const char *name, const size_t size);
+
+void dom_tree_node_serialize(const dom_tree_node_t *node, dom_buffer_t *sink);
+
+void dom_tree_serialize(const dom_tree_t *tree, dom_buffer_t *sink);
+
+#endif/*SERIAL_H*/
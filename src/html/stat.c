@@ -0,0 +1,115 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "node.h"
+#include "query.h"
+#include "stat.h"
+#include "tag.h"
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void *dom_tree_stat_array(const uint64_t count, const size_t size)
+{
+  void *ptr = NULL;
+
+  ptr = calloc((count == 0ul) ? 1ul : count, size);
+  if (ptr == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return ptr;
+}
+
+dom_tree_stat_t *dom_tree_stat_new(dom_tree_t *tree)
+{
+  dom_tree_stat_t *self = NULL;
+  dom_tree_node_t *node = NULL;
+  uint64_t parent;
+  uint64_t i;
+  uint64_t p;
+
+  self = (dom_tree_stat_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  if (tree->nodes == NULL)
+  {
+    dom_tree_number(tree);
+  }
+
+  self->count = tree->nodes->count;
+  self->size = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->size));
+  self->tags = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->tags));
+  self->depth = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->depth));
+  self->text = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->text));
+  self->links = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->links));
+  self->link_text = (uint64_t *)dom_tree_stat_array(self->count, sizeof(*self->link_text));
+  self->tag = (uint32_t *)dom_tree_stat_array(self->count, sizeof(*self->tag));
+
+  for (i = self->count; i > 0ul; i--)
+  {
+    node = tree->nodes->nodes[i - 1ul];
+    p = node->pre;
+
+    // NOTE: The descendants have already added their totals in.
+    self->tag[p] = dom_tag_id(node->name, node->namelen);
+    self->depth[p] = node->depth;
+    self->size[p] += 1ul + (0ul < node->bodylen);
+    self->tags[p] += 1ul;
+    self->text[p] += node->bodylen;
+
+    if (DOM_TAG_A == self->tag[p])
+    {
+      self->links[p] += 1ul;
+      self->link_text[p] = self->text[p];
+    }
+
+    if (node->parent == NULL)
+    {
+      continue;
+    }
+
+    parent = node->parent->pre;
+    self->size[parent] += self->size[p];
+    self->tags[parent] += self->tags[p];
+    self->text[parent] += self->text[p];
+    self->links[parent] += self->links[p];
+    self->link_text[parent] += self->link_text[p];
+  }
+
+  return self;
+}
+
+void dom_tree_stat_destroy(dom_tree_stat_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->size);
+    free(self->tags);
+    free(self->depth);
+    free(self->text);
+    free(self->links);
+    free(self->link_text);
+    free(self->tag);
+    free(self);
+    self = NULL;
+  }
+}
@@ -0,0 +1,46 @@
+#ifndef STAT_H
+#define STAT_H
+
+#include "node.h"
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Subtree statistics of every element, in side arrays indexed by
+ *        the element's 'pre' number:
+ *
+ *          size       nodes in the subtree, counting each non-empty
+ *                     body as a text node
+ *          tags       elements in the subtree, itself included
+ *          depth      depth below the root
+ *          text       body bytes in the subtree
+ *          links      <a> elements in the subtree
+ *          link_text  body bytes inside those <a> elements
+ *          tag        standard tag id of the element itself
+ */
+struct dom_tree_stat
+{
+  uint64_t count;
+  uint64_t *size;
+  uint64_t *tags;
+  uint64_t *depth;
+  uint64_t *text;
+  uint64_t *links;
+  uint64_t *link_text;
+  uint32_t *tag;
+};
+
+typedef struct dom_tree_stat dom_tree_stat_t;
+
+/**
+ * @brief Gather the statistics in one pass over the elements in reverse
+ *        document order, which sees every element after all of its
+ *        descendants. The tree is numbered first if it is not.
+ */
+dom_tree_stat_t *dom_tree_stat_new(dom_tree_t *tree);
+
+void dom_tree_stat_destroy(dom_tree_stat_t *self);
+
+#endif/*STAT_H*/
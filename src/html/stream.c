@@ -0,0 +1,401 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "css.h"
+#include "mem.h"
+#include "node.h"
+#include "scan.h"
+#include "stream.h"
+#include "walk.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CSS_STREAM_BIT(row, i)  (((row)[(i) >> 6] >> ((i) & 63ul)) & 1ul)
+
+/**
+ * @brief Split each selector of the program into its compounds. The
+ *        program lays a selector out right to left, each compound's
+ *        tests followed by the combinator joining it to the compound on
+ *        its left, and the leftmost followed by MATCH.
+ */
+static void css_stream_compile(css_stream_t *self)
+{
+  const css_prog_t *prog = self->prog;
+  css_stream_compound_t *comp = NULL;
+  uint64_t base;
+  uint64_t pc;
+  uint64_t s;
+  uint64_t i;
+  uint64_t j;
+
+  for (s = 0ul; s < prog->nsel; s++)
+  {
+    base = self->ncomp;
+
+    for (pc = prog->starts[s]; ; pc++)
+    {
+      self->comps = (css_stream_compound_t *)mem_grow(self->comps, (self->ncomp + 1ul) * sizeof(*self->comps));
+      comp = self->comps + self->ncomp++;
+      comp->pc = pc;
+
+      for (; prog->insts[pc].op != CSS_OP_MATCH && prog->insts[pc].op != CSS_OP_CHILD && prog->insts[pc].op != CSS_OP_DESCENDANT; pc++);
+
+      comp->ntests = pc - comp->pc;
+      comp->comb = prog->insts[pc].op;
+      comp->first = (comp->comb == CSS_OP_MATCH);
+      comp->last = (self->ncomp - 1ul == base);
+
+      if (comp->first)
+      {
+        break;
+      }
+    }
+
+    // NOTE: Turn the compounds of the selector left to right.
+    for (i = base, j = self->ncomp - 1ul; i < j; i++, j--)
+    {
+      css_stream_compound_t tmp = self->comps[i];
+      self->comps[i] = self->comps[j];
+      self->comps[j] = tmp;
+    }
+  }
+
+  self->words = (self->ncomp + 63ul) >> 6;
+  if (self->words == 0ul)
+  {
+    self->words = 1ul;
+  }
+}
+
+css_stream_t *css_stream_new(const css_prog_t *prog, css_stream_emit_t emit, void *ctx)
+{
+  css_stream_t *self = NULL;
+  self = (css_stream_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->prog = prog;
+  self->emit = emit;
+  self->ctx = ctx;
+
+  css_stream_compile(self);
+
+  self->cap = self->attrcap = CSS_STREAM_CAPACITY;
+  self->frames = (css_stream_frame_t *)malloc(self->cap * sizeof(*self->frames));
+  self->own = (uint64_t *)calloc(self->cap * self->words, sizeof(*self->own));
+  self->inherit = (uint64_t *)calloc(self->cap * self->words, sizeof(*self->inherit));
+  self->attrs = (css_stream_attr_t *)malloc(self->attrcap * sizeof(*self->attrs));
+  self->values = (dom_tree_node_attr_t **)calloc(self->attrcap, sizeof(*self->values));
+  self->valcaps = (size_t *)calloc(self->attrcap, sizeof(*self->valcaps));
+  if (self->frames == NULL || self->own == NULL || self->inherit == NULL ||
+      self->attrs == NULL || self->values == NULL || self->valcaps == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void css_stream_destroy(css_stream_t *self)
+{
+  uint64_t i;
+
+  if (self != NULL)
+  {
+    for (i = 0ul; i < self->attrcap; i++)
+    {
+      dom_tree_node_attr_destroy(self->values[i]);
+    }
+
+    free(self->comps);
+    free(self->frames);
+    free(self->own);
+    free(self->inherit);
+    free(self->attrs);
+    free(self->values);
+    free(self->valcaps);
+    free(self);
+    self = NULL;
+  }
+}
+
+void css_stream_reset(css_stream_t *self)
+{
+  self->depth = 0ul;
+  self->nattrs = 0ul;
+  self->pending = false;
+}
+
+/**
+ * @brief Note where the content of the innermost element starts, on the
+ *        first event after its start tag.
+ */
+static void css_stream_content(css_stream_t *self, const uint8_t *p)
+{
+  if (self->pending)
+  {
+    self->frames[self->depth - 1ul].text = p;
+    self->pending = false;
+  }
+}
+
+static void css_stream_open(void *ctx, const uint8_t *name, const size_t size)
+{
+  css_stream_t *self = (css_stream_t *)ctx;
+  css_stream_frame_t *frame = NULL;
+
+  css_stream_content(self, name - 1);
+
+  // NOTE: Row zero stands for the document, so a frame at depth d owns
+  //       row d + 1.
+  if ((self->depth + 2ul) > self->cap)
+  {
+    self->cap <<= 1;
+    self->frames = (css_stream_frame_t *)mem_grow(self->frames, self->cap * sizeof(*self->frames));
+    self->own = (uint64_t *)mem_grow(self->own, self->cap * self->words * sizeof(*self->own));
+    self->inherit = (uint64_t *)mem_grow(self->inherit, self->cap * self->words * sizeof(*self->inherit));
+  }
+
+  if (0ul < self->depth)
+  {
+    self->frames[self->depth - 1ul].children++;
+  }
+
+  frame = self->frames + self->depth++;
+  frame->name = name;
+  frame->namelen = size;
+  frame->attrs = self->nattrs;
+  frame->nattrs = 0ul;
+  frame->children = 0l;
+  frame->text = NULL;
+  frame->matched = false;
+}
+
+static void css_stream_attr(void *ctx, const uint8_t *name, const size_t namelen, const uint8_t *value, const size_t vallen)
+{
+  css_stream_t *self = (css_stream_t *)ctx;
+  dom_tree_node_attr_t *attr = NULL;
+  css_stream_attr_t *span = NULL;
+  const size_t old = self->attrcap;
+  size_t len;
+
+  if (self->nattrs >= self->attrcap)
+  {
+    self->attrcap <<= 1;
+    self->attrs = (css_stream_attr_t *)mem_grow(self->attrs, self->attrcap * sizeof(*self->attrs));
+    self->values = (dom_tree_node_attr_t **)mem_grow(self->values, self->attrcap * sizeof(*self->values));
+    self->valcaps = (size_t *)mem_grow(self->valcaps, self->attrcap * sizeof(*self->valcaps));
+    memset(self->values + old, 0, (self->attrcap - old) * sizeof(*self->values));
+    memset(self->valcaps + old, 0, (self->attrcap - old) * sizeof(*self->valcaps));
+  }
+
+  span = self->attrs + self->nattrs;
+  span->name = name;
+  span->namelen = namelen;
+  span->value = value;
+  span->vallen = vallen;
+
+  // NOTE: The tests read terminated attributes, so each slot keeps a
+  //       copy whose buffer is reused by later elements.
+  if (self->values[self->nattrs] == NULL)
+  {
+    self->values[self->nattrs] = dom_tree_node_attr_new(NULL, NULL);
+  }
+  attr = self->values[self->nattrs];
+
+  len = (namelen < sizeof(attr->name)) ? namelen : (sizeof(attr->name) - 1ul);
+  memcpy(attr->name, name, len);
+  attr->name[len] = '\0';
+
+  if (self->valcaps[self->nattrs] < vallen + 1ul)
+  {
+    self->valcaps[self->nattrs] = vallen + 1ul;
+    attr->value = (char *)mem_grow(attr->value, self->valcaps[self->nattrs]);
+  }
+  memcpy(attr->value, value, vallen);
+  attr->value[vallen] = '\0';
+  attr->vallen = vallen;
+
+  self->nattrs++;
+}
+
+static bool css_stream_test(css_stream_t *self, const css_stream_compound_t *comp, const int64_t n)
+{
+  const css_inst_t *inst = NULL;
+  uint64_t i;
+
+  for (i = 0ul; i < comp->ntests; i++)
+  {
+    inst = self->prog->insts + comp->pc + i;
+
+    if (inst->op == CSS_OP_NTH_CHILD)
+    {
+      if (!css_nth_match(inst->a, inst->b, n))
+      {
+        return false;
+      }
+    }
+    else if (!css_test(self->prog, inst, &self->node))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void css_stream_open_end(void *ctx)
+{
+  css_stream_t *self = (css_stream_t *)ctx;
+  css_stream_frame_t *frame = self->frames + (self->depth - 1ul);
+  const uint64_t *up = self->own + (self->depth - 1ul) * self->words;
+  const uint64_t *above = self->inherit + (self->depth - 1ul) * self->words;
+  uint64_t *own = self->own + self->depth * self->words;
+  uint64_t *inherit = self->inherit + self->depth * self->words;
+  const css_stream_compound_t *comp = NULL;
+  int64_t n;
+  uint64_t i;
+
+  frame->nattrs = self->nattrs - frame->attrs;
+
+  self->node.name = (char *)frame->name;
+  self->node.namelen = frame->namelen;
+  self->node.attrs = self->values + frame->attrs;
+  self->node.attrs_count = frame->nattrs;
+
+  n = (1ul < self->depth) ? self->frames[self->depth - 2ul].children : 1l;
+
+  if (self->depth == 1ul)
+  {
+    memset(self->own, 0, self->words * sizeof(*self->own));
+    memset(self->inherit, 0, self->words * sizeof(*self->inherit));
+  }
+
+  memset(own, 0, self->words * sizeof(*own));
+
+  for (i = 0ul; i < self->ncomp; i++)
+  {
+    comp = self->comps + i;
+
+    if (!comp->first &&
+        !CSS_STREAM_BIT((comp->comb == CSS_OP_CHILD) ? up : above, i - 1ul))
+    {
+      continue;
+    }
+
+    if (css_stream_test(self, comp, n))
+    {
+      own[i >> 6] |= 1ul << (i & 63ul);
+      frame->matched = frame->matched || comp->last;
+    }
+  }
+
+  for (i = 0ul; i < self->words; i++)
+  {
+    inherit[i] = above[i] | own[i];
+  }
+
+  self->pending = true;
+}
+
+static void css_stream_text(void *ctx, const uint8_t *data, const size_t size)
+{
+  css_stream_t *self = (css_stream_t *)ctx;
+
+  (void)size;
+
+  css_stream_content(self, data);
+}
+
+static void css_stream_pop(css_stream_t *self, const uint8_t *end)
+{
+  css_stream_frame_t *frame = self->frames + --self->depth;
+  css_stream_match_t match;
+
+  if (frame->matched)
+  {
+    match.name = frame->name;
+    match.namelen = frame->namelen;
+    match.attrs = self->attrs + frame->attrs;
+    match.nattrs = frame->nattrs;
+    match.text = (frame->text == NULL || end == NULL) ? end : frame->text;
+    match.textlen = (frame->text == NULL || end == NULL) ? 0ul : (size_t)(end - frame->text);
+    match.depth = self->depth;
+    self->emit(self->ctx, &match);
+  }
+
+  self->nattrs = frame->attrs;
+}
+
+static void css_stream_close(void *ctx, const uint8_t *name, const size_t size)
+{
+  css_stream_t *self = (css_stream_t *)ctx;
+  const css_stream_frame_t *frame = NULL;
+  uint64_t i;
+
+  if (0ul == self->depth)
+  {
+    return;
+  }
+
+  // NOTE: Void and self-closed elements are closed with the name of
+  //       their own start tag and have no content.
+  if (self->frames[self->depth - 1ul].name == name)
+  {
+    self->pending = false;
+    css_stream_pop(self, NULL);
+    return;
+  }
+
+  css_stream_content(self, name - 2);
+
+  for (i = self->depth; 0ul < i; i--)
+  {
+    frame = self->frames + (i - 1ul);
+    if (frame->namelen == size && 0 == memcmp(frame->name, name, size))
+    {
+      break;
+    }
+  }
+
+  // NOTE: A stray end tag closes nothing; one that matches an outer
+  //       element also closes those left open inside it.
+  while (0ul < i && i <= self->depth)
+  {
+    css_stream_pop(self, name - 2);
+  }
+}
+
+static const html_walker_t css_stream_walker = {
+  NULL,
+  &css_stream_open,
+  &css_stream_attr,
+  &css_stream_open_end,
+  &css_stream_text,
+  &css_stream_close,
+};
+
+int css_stream_walk(css_stream_t *self, const html_scan_t *scan, const uint8_t *data, const size_t size)
+{
+  return html_walk(scan, data, size, &css_stream_walker, self);
+}
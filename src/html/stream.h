@@ -0,0 +1,123 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "attr.h"
+#include "css.h"
+#include "node.h"
+#include "scan.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CSS_STREAM_CAPACITY (1ul << 5)
+
+struct css_stream_attr
+{
+  const uint8_t *name;
+  size_t namelen;
+  const uint8_t *value;
+  size_t vallen;
+};
+
+typedef struct css_stream_attr css_stream_attr_t;
+
+/**
+ * @brief A matching element, reported when it closes. Every span points
+ *        into the buffer being walked; 'text' is everything between the
+ *        element's tags.
+ */
+struct css_stream_match
+{
+  const uint8_t *name;
+  size_t namelen;
+  const css_stream_attr_t *attrs;
+  uint64_t nattrs;
+  const uint8_t *text;
+  size_t textlen;
+  uint64_t depth;
+};
+
+typedef struct css_stream_match css_stream_match_t;
+
+typedef void (*css_stream_emit_t)(void *, const css_stream_match_t *);
+
+/**
+ * @brief One compound of a selector, numbered left to right. 'first'
+ *        marks the leftmost compound of its selector and 'last' the
+ *        rightmost, whose success is a match.
+ */
+struct css_stream_compound
+{
+  uint64_t pc;
+  uint64_t ntests;
+  int comb;
+  bool first;
+  bool last;
+};
+
+typedef struct css_stream_compound css_stream_compound_t;
+
+struct css_stream_frame
+{
+  const uint8_t *name;
+  size_t namelen;
+  uint64_t attrs;
+  uint64_t nattrs;
+  int64_t children;
+  const uint8_t *text;
+  bool matched;
+};
+
+typedef struct css_stream_frame css_stream_frame_t;
+
+/**
+ * @brief Selector matcher driven by the walker's events, so no tree is
+ *        built. Each open element keeps a row of bits, one per compound:
+ *        'own' for the compounds matched at the element and 'inherit'
+ *        for those matched at it or any ancestor. A compound matches an
+ *        element when its tests pass and the compound to its left is set
+ *        in the parent's 'own' row for '>' or 'inherit' row for ' '.
+ *        Memory grows with the nesting depth only.
+ */
+struct css_stream
+{
+  const css_prog_t *prog;
+  css_stream_emit_t emit;
+  void *ctx;
+  uint64_t ncomp;
+  css_stream_compound_t *comps;
+  uint64_t words;
+  size_t cap;
+  uint64_t depth;
+  css_stream_frame_t *frames;
+  uint64_t *own;
+  uint64_t *inherit;
+  size_t attrcap;
+  uint64_t nattrs;
+  css_stream_attr_t *attrs;
+  dom_tree_node_attr_t **values;
+  size_t *valcaps;
+  dom_tree_node_t node;
+  bool pending;
+};
+
+typedef struct css_stream css_stream_t;
+
+/**
+ * @brief Create a matcher for the program, which must outlive it.
+ */
+css_stream_t *css_stream_new(const css_prog_t *prog, css_stream_emit_t emit, void *ctx);
+
+void css_stream_destroy(css_stream_t *self);
+
+void css_stream_reset(css_stream_t *self);
+
+/**
+ * @brief Match the program against a buffer as it is walked, reporting
+ *        every matching element to the callback. Returns the walker's
+ *        final state.
+ */
+int css_stream_walk(css_stream_t *self, const html_scan_t *scan, const uint8_t *data, const size_t size);
+
+#endif/*STREAM_H*/
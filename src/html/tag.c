@@ -0,0 +1,237 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "node.h"
+#include "tag.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const dom_tag_names[DOM_TAG_COUNT] = {
+  NULL,
+  "a", "abbr", "address", "area", "article", "aside", "audio", "b",
+  "base", "bdi", "bdo", "blockquote", "body", "br", "button", "canvas",
+  "caption", "cite", "code", "col", "colgroup", "data", "datalist", "dd",
+  "del", "details", "dfn", "dialog", "div", "dl", "dt", "em", "embed",
+  "fieldset", "figcaption", "figure", "footer", "form", "h1", "h2", "h3",
+  "h4", "h5", "h6", "head", "header", "hgroup", "hr", "html", "i",
+  "iframe", "img", "input", "ins", "kbd", "label", "legend", "li",
+  "link", "main", "map", "mark", "menu", "meta", "meter", "nav",
+  "noscript", "object", "ol", "optgroup", "option", "output", "p",
+  "param", "picture", "pre", "progress", "q", "rp", "rt", "ruby", "s",
+  "samp", "script", "search", "section", "select", "slot", "small",
+  "source", "span", "strong", "style", "sub", "summary", "sup", "svg",
+  "table", "tbody", "td", "template", "textarea", "tfoot", "th", "thead",
+  "time", "title", "tr", "track", "u", "ul", "var", "video", "wbr",
+};
+
+/**
+ * @brief Compare a name against a lower case tag name, ignoring case.
+ */
+static int dom_tag_cmp(const char *name, const size_t size, const char *tag)
+{
+  size_t i;
+  int c;
+
+  for (i = 0ul; i < size; i++)
+  {
+    if (tag[i] == '\0')
+    {
+      return 1;
+    }
+
+    c = tolower((unsigned char)name[i]) - (unsigned char)tag[i];
+    if (c != 0)
+    {
+      return c;
+    }
+  }
+
+  return (tag[i] == '\0') ? 0 : -1;
+}
+
+uint32_t dom_tag_id(const char *name, const size_t size)
+{
+  uint32_t lo = 1u;
+  uint32_t hi = DOM_TAG_COUNT;
+  uint32_t mid;
+  int c;
+
+  while (lo < hi)
+  {
+    mid = lo + ((hi - lo) >> 1);
+    c = dom_tag_cmp(name, size, dom_tag_names[mid]);
+    if (c == 0)
+    {
+      return mid;
+    }
+    if (c < 0)
+    {
+      hi = mid;
+    }
+    else
+    {
+      lo = mid + 1u;
+    }
+  }
+
+  return DOM_TAG_UNKNOWN;
+}
+
+const char *dom_tag_name(const uint32_t id)
+{
+  return (id < DOM_TAG_COUNT) ? dom_tag_names[id] : NULL;
+}
+
+dom_tag_index_t *dom_tag_index_new(void)
+{
+  dom_tag_index_t *self = NULL;
+  self = (dom_tag_index_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->count = DOM_TAG_COUNT;
+  self->cap = DOM_TAG_COUNT + DOM_TAG_INDEX_CAPACITY;
+  self->lists = (dom_tree_node_list_t **)calloc(self->cap, sizeof(*self->lists));
+  self->names = (char **)calloc(self->cap - DOM_TAG_COUNT, sizeof(*self->names));
+  if (self->lists == NULL || self->names == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_tag_index_destroy(dom_tag_index_t *self)
+{
+  uint64_t i;
+
+  if (self != NULL)
+  {
+    for (i = 0ul; i < self->count; i++)
+    {
+      dom_tree_node_list_destroy(self->lists[i]);
+    }
+
+    for (i = DOM_TAG_COUNT; i < self->count; i++)
+    {
+      free(self->names[i - DOM_TAG_COUNT]);
+    }
+
+    free(self->lists);
+    free(self->names);
+    free(self);
+    self = NULL;
+  }
+}
+
+static uint32_t dom_tag_index_add(dom_tag_index_t *self, const char *name, const size_t size)
+{
+  char *copy = NULL;
+  size_t i;
+
+  if (self->count >= self->cap)
+  {
+    void *__old = self->lists;
+    self->lists = NULL;
+    self->lists = (dom_tree_node_list_t **)realloc(__old, (self->cap << 1) * sizeof(*self->lists));
+    if (self->lists == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+    memset(self->lists + self->cap, 0, self->cap * sizeof(*self->lists));
+
+    __old = self->names;
+    self->names = NULL;
+    self->names = (char **)realloc(__old, ((self->cap << 1) - DOM_TAG_COUNT) * sizeof(*self->names));
+    if (self->names == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+
+    self->cap <<= 1;
+  }
+
+  copy = (char *)malloc((size + 1ul) * sizeof(*copy));
+  if (copy == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0ul; i < size; i++)
+  {
+    copy[i] = (char)tolower((unsigned char)name[i]);
+  }
+  copy[size] = '\0';
+
+  self->names[self->count - DOM_TAG_COUNT] = copy;
+  return (uint32_t)self->count++;
+}
+
+uint32_t dom_tag_index_id(dom_tag_index_t *self, const char *name, const size_t size, const bool add)
+{
+  uint32_t id;
+  uint64_t i;
+
+  id = dom_tag_id(name, size);
+  if (id != DOM_TAG_UNKNOWN)
+  {
+    return id;
+  }
+
+  // NOTE: Documents use few non-standard names, so they are searched
+  //       in the order they were first seen.
+  for (i = DOM_TAG_COUNT; i < self->count; i++)
+  {
+    if (0 == dom_tag_cmp(name, size, self->names[i - DOM_TAG_COUNT]))
+    {
+      return (uint32_t)i;
+    }
+  }
+
+  return add ? dom_tag_index_add(self, name, size) : DOM_TAG_UNKNOWN;
+}
+
+void dom_tag_index_insert(dom_tag_index_t *self, dom_tree_node_t *node)
+{
+  dom_tree_node_list_t *list = NULL;
+  uint64_t i;
+
+  node->tag = dom_tag_index_id(self, node->name, node->namelen, true);
+
+  if (self->lists[node->tag] == NULL)
+  {
+    self->lists[node->tag] = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+  }
+
+  list = self->lists[node->tag] = dom_tree_node_list_append(self->lists[node->tag], node);
+
+  // NOTE: Elements complete innermost first, so a node may have to move
+  //       in front of the same-tag elements that enclose it.
+  for (i = list->count - 1ul; i > 0ul && list->nodes[i - 1ul]->pre > node->pre; i--)
+  {
+    list->nodes[i] = list->nodes[i - 1ul];
+  }
+  list->nodes[i] = node;
+}
@@ -0,0 +1,176 @@
+#ifndef TAG_H
+#define TAG_H
+
+#include "node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Ids of the standard HTML elements, in the alphabetical order of
+ *        their names. Other names get ids from DOM_TAG_COUNT upwards,
+ *        assigned per document by the tag index.
+ */
+enum
+{
+  DOM_TAG_UNKNOWN,
+  DOM_TAG_A,
+  DOM_TAG_ABBR,
+  DOM_TAG_ADDRESS,
+  DOM_TAG_AREA,
+  DOM_TAG_ARTICLE,
+  DOM_TAG_ASIDE,
+  DOM_TAG_AUDIO,
+  DOM_TAG_B,
+  DOM_TAG_BASE,
+  DOM_TAG_BDI,
+  DOM_TAG_BDO,
+  DOM_TAG_BLOCKQUOTE,
+  DOM_TAG_BODY,
+  DOM_TAG_BR,
+  DOM_TAG_BUTTON,
+  DOM_TAG_CANVAS,
+  DOM_TAG_CAPTION,
+  DOM_TAG_CITE,
+  DOM_TAG_CODE,
+  DOM_TAG_COL,
+  DOM_TAG_COLGROUP,
+  DOM_TAG_DATA,
+  DOM_TAG_DATALIST,
+  DOM_TAG_DD,
+  DOM_TAG_DEL,
+  DOM_TAG_DETAILS,
+  DOM_TAG_DFN,
+  DOM_TAG_DIALOG,
+  DOM_TAG_DIV,
+  DOM_TAG_DL,
+  DOM_TAG_DT,
+  DOM_TAG_EM,
+  DOM_TAG_EMBED,
+  DOM_TAG_FIELDSET,
+  DOM_TAG_FIGCAPTION,
+  DOM_TAG_FIGURE,
+  DOM_TAG_FOOTER,
+  DOM_TAG_FORM,
+  DOM_TAG_H1,
+  DOM_TAG_H2,
+  DOM_TAG_H3,
+  DOM_TAG_H4,
+  DOM_TAG_H5,
+  DOM_TAG_H6,
+  DOM_TAG_HEAD,
+  DOM_TAG_HEADER,
+  DOM_TAG_HGROUP,
+  DOM_TAG_HR,
+  DOM_TAG_HTML,
+  DOM_TAG_I,
+  DOM_TAG_IFRAME,
+  DOM_TAG_IMG,
+  DOM_TAG_INPUT,
+  DOM_TAG_INS,
+  DOM_TAG_KBD,
+  DOM_TAG_LABEL,
+  DOM_TAG_LEGEND,
+  DOM_TAG_LI,
+  DOM_TAG_LINK,
+  DOM_TAG_MAIN,
+  DOM_TAG_MAP,
+  DOM_TAG_MARK,
+  DOM_TAG_MENU,
+  DOM_TAG_META,
+  DOM_TAG_METER,
+  DOM_TAG_NAV,
+  DOM_TAG_NOSCRIPT,
+  DOM_TAG_OBJECT,
+  DOM_TAG_OL,
+  DOM_TAG_OPTGROUP,
+  DOM_TAG_OPTION,
+  DOM_TAG_OUTPUT,
+  DOM_TAG_P,
+  DOM_TAG_PARAM,
+  DOM_TAG_PICTURE,
+  DOM_TAG_PRE,
+  DOM_TAG_PROGRESS,
+  DOM_TAG_Q,
+  DOM_TAG_RP,
+  DOM_TAG_RT,
+  DOM_TAG_RUBY,
+  DOM_TAG_S,
+  DOM_TAG_SAMP,
+  DOM_TAG_SCRIPT,
+  DOM_TAG_SEARCH,
+  DOM_TAG_SECTION,
+  DOM_TAG_SELECT,
+  DOM_TAG_SLOT,
+  DOM_TAG_SMALL,
+  DOM_TAG_SOURCE,
+  DOM_TAG_SPAN,
+  DOM_TAG_STRONG,
+  DOM_TAG_STYLE,
+  DOM_TAG_SUB,
+  DOM_TAG_SUMMARY,
+  DOM_TAG_SUP,
+  DOM_TAG_SVG,
+  DOM_TAG_TABLE,
+  DOM_TAG_TBODY,
+  DOM_TAG_TD,
+  DOM_TAG_TEMPLATE,
+  DOM_TAG_TEXTAREA,
+  DOM_TAG_TFOOT,
+  DOM_TAG_TH,
+  DOM_TAG_THEAD,
+  DOM_TAG_TIME,
+  DOM_TAG_TITLE,
+  DOM_TAG_TR,
+  DOM_TAG_TRACK,
+  DOM_TAG_U,
+  DOM_TAG_UL,
+  DOM_TAG_VAR,
+  DOM_TAG_VIDEO,
+  DOM_TAG_WBR,
+  DOM_TAG_COUNT,
+};
+
+/**
+ * @brief Return the id of a standard element name, ignoring case, or
+ *        DOM_TAG_UNKNOWN.
+ */
+uint32_t dom_tag_id(const char *name, const size_t size);
+
+const char *dom_tag_name(const uint32_t id);
+
+#define DOM_TAG_INDEX_CAPACITY (1ul << 3)
+
+/**
+ * @brief Per document index from tag id to the elements with that tag,
+ *        each list kept in document order.
+ */
+struct dom_tag_index
+{
+  size_t cap;
+  uint64_t count;
+  char **names;
+  dom_tree_node_list_t **lists;
+};
+
+typedef struct dom_tag_index dom_tag_index_t;
+
+dom_tag_index_t *dom_tag_index_new(void);
+
+void dom_tag_index_destroy(dom_tag_index_t *self);
+
+/**
+ * @brief Return the id of the name in this document, or DOM_TAG_UNKNOWN
+ *        when it is neither a standard name nor one seen so far. With
+ *        'add' set, unseen names are given a new id instead.
+ */
+uint32_t dom_tag_index_id(dom_tag_index_t *self, const char *name, const size_t size, const bool add);
+
+/**
+ * @brief Add a completed element, keeping its list in document order by
+ *        its 'pre' number.
+ */
+void dom_tag_index_insert(dom_tag_index_t *self, dom_tree_node_t *node);
+
+#endif/*TAG_H*/
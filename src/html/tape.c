@@ -0,0 +1,883 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "graph.h"
+#include "mem.h"
+#include "node.h"
+#include "scan.h"
+#include "serial.h"
+#include "tape.h"
+#include "trav.h"
+#include "tree.h"
+#include "walk.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DOM_TAPE_NAMES_CAPACITY (1ul << 6)
+
+#define DOM_TAPE_MAGIC   "blitztap"
+#define DOM_TAPE_VERSION 1u
+#define DOM_TAPE_BOM     0x01020304u
+
+/**
+ * @brief Leading block of a saved tape. The entries follow right after
+ *        it, then the strings, so every reference inside the file is an
+ *        offset and the file can be used wherever it is mapped.
+ */
+struct dom_tape_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t bom;
+  uint64_t count;
+  uint64_t strsize;
+};
+
+typedef struct dom_tape_header dom_tape_header_t;
+
+#define DOM_TAPE_ENTRY(type, id, value) \
+  ((((uint64_t)(type)) << 56) | (((uint64_t)(id)) << 32) | ((uint64_t)(value)))
+
+/**
+ * @brief Scratch state used while a tape is written: the name interning
+ *        table and, when parsing, the stack of open elements.
+ */
+struct dom_tape_builder
+{
+  dom_tape_t *tape;
+  size_t namecap;
+  uint64_t namecount;
+  uint32_t *names;
+  uint32_t *slots;
+  size_t cap;
+  uint64_t top;
+  uint64_t *stack;
+  char doctype[256];
+};
+
+typedef struct dom_tape_builder dom_tape_builder_t;
+
+static uint64_t dom_tape_push(dom_tape_t *self, const int type, const uint32_t id, const uint32_t value)
+{
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->entries = (uint64_t *)mem_grow(self->entries, self->cap * sizeof(*self->entries));
+  }
+
+  if (self->count >= UINT32_MAX)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "document too large for tape");
+    exit(EXIT_FAILURE);
+  }
+
+  self->entries[self->count] = DOM_TAPE_ENTRY(type, id, value);
+  return self->count++;
+}
+
+static uint8_t *dom_tape_reserve(dom_tape_t *self, const size_t size)
+{
+  const size_t need = self->strsize + sizeof(uint32_t) + size + 1ul;
+
+  if (need > UINT32_MAX)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "document too large for tape");
+    exit(EXIT_FAILURE);
+  }
+
+  if (need > self->strcap)
+  {
+    while (need > self->strcap)
+    {
+      self->strcap <<= 1;
+    }
+    self->strings = (uint8_t *)mem_grow(self->strings, self->strcap * sizeof(*self->strings));
+  }
+
+  return self->strings + self->strsize + sizeof(uint32_t);
+}
+
+/**
+ * @brief Seal a string written into reserved space, returning its
+ *        offset.
+ */
+static uint32_t dom_tape_commit(dom_tape_t *self, const size_t size)
+{
+  const uint32_t offset = (uint32_t)self->strsize;
+  const uint32_t len = (uint32_t)size;
+
+  memcpy(self->strings + offset, &len, sizeof(len));
+  self->strings[offset + sizeof(len) + size] = '\0';
+  self->strsize += sizeof(len) + size + 1ul;
+  return offset;
+}
+
+static uint32_t dom_tape_store(dom_tape_t *self, const void *data, const size_t size)
+{
+  if (0ul < size)
+  {
+    memcpy(dom_tape_reserve(self, size), data, size);
+  }
+  else
+  {
+    dom_tape_reserve(self, size);
+  }
+  return dom_tape_commit(self, size);
+}
+
+static uint64_t dom_tape_hash(const void *data, const size_t size)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  uint64_t hash = 0xcbf29ce484222325ul;
+  size_t i;
+
+  for (i = 0ul; i < size; i++)
+  {
+    hash ^= p[i];
+    hash *= 0x100000001b3ul;
+  }
+
+  return hash;
+}
+
+static dom_tape_t *dom_tape_alloc(void)
+{
+  dom_tape_t *self = NULL;
+  self = (dom_tape_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = DOM_TAPE_CAPACITY;
+  self->strcap = DOM_TAPE_STRINGS_CAPACITY;
+  self->entries = (uint64_t *)malloc(self->cap * sizeof(*self->entries));
+  self->strings = (uint8_t *)malloc(self->strcap * sizeof(*self->strings));
+  if (self->entries == NULL || self->strings == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_tape_destroy(dom_tape_t *self)
+{
+  if (self != NULL)
+  {
+    if (self->map != NULL)
+    {
+      munmap(self->map, self->mapsize);
+      self->map = NULL;
+      self->entries = NULL;
+      self->strings = NULL;
+    }
+
+    if (self->entries != NULL)
+    {
+      free(self->entries);
+      self->entries = NULL;
+    }
+
+    if (self->strings != NULL)
+    {
+      free(self->strings);
+      self->strings = NULL;
+    }
+
+    free(self);
+    self = NULL;
+  }
+}
+
+int dom_tape_save(const dom_tape_t *self, const char *path)
+{
+  char const mode[] = "wb";
+  dom_tape_header_t header;
+  FILE *fd = NULL;
+  int r;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DOM_TAPE_MAGIC, sizeof(header.magic));
+  header.version = DOM_TAPE_VERSION;
+  header.bom = DOM_TAPE_BOM;
+  header.count = self->count;
+  header.strsize = self->strsize;
+
+  fd = fopen(path, mode);
+  if (fd == NULL)
+  {
+    fprintf(stderr, "fopen() failed to open a file on the disk\n");
+    return (-1);
+  }
+
+  if (1ul != fwrite(&header, sizeof(header), 1ul, fd) ||
+      self->count != fwrite(self->entries, sizeof(*self->entries), self->count, fd) ||
+      self->strsize != fwrite(self->strings, sizeof(*self->strings), self->strsize, fd))
+  {
+    fprintf(stderr, "fwrite() failed to write all bytes to file\n");
+
+    r = fclose(fd);
+    if (r == EOF)
+    {
+      fprintf(stderr, "cannot close file handler\n");
+    }
+
+    fd = NULL;
+    return (-1);
+  }
+
+  r = fclose(fd);
+  if (r == EOF)
+  {
+    fprintf(stderr, "cannot close file handler\n");
+    return (-1);
+  }
+
+  fd = NULL;
+  return 0;
+}
+
+int dom_tree_save(const dom_tree_t *tree, const char *path)
+{
+  dom_tape_t *tape = NULL;
+  int r;
+
+  tape = dom_tape_new(tree);
+  r = dom_tape_save(tape, path);
+  dom_tape_destroy(tape);
+  return r;
+}
+
+dom_tape_t *dom_tree_load_mmap(const char *path)
+{
+  const dom_tape_header_t *header = NULL;
+  dom_tape_t *self = NULL;
+  struct stat st;
+  void *map = NULL;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr, "open() failed to open a file on the disk\n");
+    return NULL;
+  }
+
+  if (0 != fstat(fd, &st) || (size_t)st.st_size < sizeof(*header))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "not a saved document");
+    close(fd);
+    return NULL;
+  }
+
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "mmap() failed to map the file\n");
+    return NULL;
+  }
+
+  header = (const dom_tape_header_t *)map;
+  if (0 != memcmp(header->magic, DOM_TAPE_MAGIC, sizeof(header->magic)) ||
+      DOM_TAPE_VERSION != header->version || DOM_TAPE_BOM != header->bom ||
+      header->count < 3ul || header->count > UINT32_MAX || header->strsize > UINT32_MAX ||
+      (size_t)st.st_size != sizeof(*header) + header->count * sizeof(uint64_t) + header->strsize)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "not a saved document");
+    munmap(map, (size_t)st.st_size);
+    return NULL;
+  }
+
+  self = (dom_tape_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = self->count = header->count;
+  self->strcap = self->strsize = header->strsize;
+  self->entries = (uint64_t *)((uint8_t *)map + sizeof(*header));
+  self->strings = (uint8_t *)map + sizeof(*header) + header->count * sizeof(uint64_t);
+  self->map = map;
+  self->mapsize = (size_t)st.st_size;
+  return self;
+}
+
+static void dom_tape_builder_setup(dom_tape_builder_t *self)
+{
+  memset(self, 0, sizeof(*self));
+
+  self->tape = dom_tape_alloc();
+  self->namecap = DOM_TAPE_NAMES_CAPACITY;
+  self->names = (uint32_t *)malloc(self->namecap * sizeof(*self->names));
+  self->slots = (uint32_t *)calloc(self->namecap << 1, sizeof(*self->slots));
+  if (self->names == NULL || self->slots == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  dom_tape_push(self->tape, DOM_TAPE_ROOT, 0u, 0u);
+  dom_tape_push(self->tape, DOM_TAPE_DOCTYPE, 0u, 0u);
+}
+
+static bool dom_tape_name_eq(const dom_tape_t *self, const uint32_t offset, const void *name, const size_t size)
+{
+  size_t len;
+  const char *other = dom_tape_string(self, offset, &len);
+  return len == size && 0 == memcmp(other, name, size);
+}
+
+/**
+ * @brief Find the slot holding the name, or the empty slot where it
+ *        belongs. The table is open addressed and kept at most half
+ *        full.
+ */
+static uint64_t dom_tape_probe(const dom_tape_builder_t *self, const void *name, const size_t size)
+{
+  const uint64_t mask = (self->namecap << 1) - 1ul;
+  uint64_t i;
+
+  for (i = dom_tape_hash(name, size) & mask; self->slots[i] != 0u; i = (i + 1ul) & mask)
+  {
+    if (dom_tape_name_eq(self->tape, self->names[self->slots[i] - 1u], name, size))
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+/**
+ * @brief Return the id of the name, adding it to the table on first
+ *        sight.
+ */
+static uint32_t dom_tape_intern(dom_tape_builder_t *self, const void *name, const size_t size)
+{
+  const char *other = NULL;
+  size_t len;
+  uint64_t i;
+  uint64_t j;
+
+  i = dom_tape_probe(self, name, size);
+  if (self->slots[i] != 0u)
+  {
+    return self->slots[i] - 1u;
+  }
+
+  if (self->namecount >= 0xfffffful)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "too many distinct names for tape");
+    exit(EXIT_FAILURE);
+  }
+
+  self->names[self->namecount] = dom_tape_store(self->tape, name, size);
+  self->slots[i] = (uint32_t)++self->namecount;
+
+  if (self->namecount >= self->namecap)
+  {
+    self->namecap <<= 1;
+    self->names = (uint32_t *)mem_grow(self->names, self->namecap * sizeof(*self->names));
+
+    free(self->slots);
+    self->slots = (uint32_t *)calloc(self->namecap << 1, sizeof(*self->slots));
+    if (self->slots == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+
+    for (j = 0ul; j < self->namecount; j++)
+    {
+      other = dom_tape_string(self->tape, self->names[j], &len);
+      self->slots[dom_tape_probe(self, other, len)] = (uint32_t)(j + 1ul);
+    }
+  }
+
+  return (uint32_t)(self->namecount - 1ul);
+}
+
+/**
+ * @brief Close the document section and append the name table, then
+ *        hand the tape over.
+ */
+static dom_tape_t *dom_tape_builder_finish(dom_tape_builder_t *self)
+{
+  dom_tape_t *tape = self->tape;
+  uint64_t end;
+  uint64_t i;
+
+  tape->entries[1] = DOM_TAPE_ENTRY(DOM_TAPE_DOCTYPE, 0u, dom_tape_store(tape, self->doctype, strlen(self->doctype)));
+
+  end = dom_tape_push(tape, DOM_TAPE_ROOT, 0u, 0u);
+  tape->entries[0] = DOM_TAPE_ENTRY(DOM_TAPE_ROOT, 0u, (uint32_t)end);
+
+  for (i = 0ul; i < self->namecount; i++)
+  {
+    dom_tape_push(tape, DOM_TAPE_NAME, 0u, self->names[i]);
+  }
+
+  free(self->names);
+  free(self->slots);
+  if (self->stack != NULL)
+  {
+    free(self->stack);
+  }
+
+  self->names = NULL;
+  self->slots = NULL;
+  self->stack = NULL;
+  self->tape = NULL;
+  return tape;
+}
+
+static void dom_tape_stack_push(dom_tape_builder_t *self, const uint64_t i)
+{
+  if (self->top >= self->cap)
+  {
+    self->cap = (self->cap == 0ul) ? DOM_TAPE_NAMES_CAPACITY : (self->cap << 1);
+    self->stack = (uint64_t *)mem_grow(self->stack, self->cap * sizeof(*self->stack));
+  }
+
+  self->stack[self->top++] = i;
+}
+
+static void dom_tape_close_top(dom_tape_builder_t *self)
+{
+  const uint64_t open = self->stack[--self->top];
+  const uint32_t id = DOM_TAPE_NAME_ID(self->tape->entries[open]);
+  const uint64_t close = dom_tape_push(self->tape, DOM_TAPE_CLOSE, id, (uint32_t)open);
+
+  self->tape->entries[open] = DOM_TAPE_ENTRY(DOM_TAPE_OPEN, id, (uint32_t)close);
+}
+
+static void dom_tape_enter(dom_tape_builder_t *self, const dom_tree_node_t *node)
+{
+  const dom_tree_node_attr_t *attr = NULL;
+  uint64_t i;
+
+  dom_tape_stack_push(self, dom_tape_push(self->tape, DOM_TAPE_OPEN, dom_tape_intern(self, node->name, node->namelen), 0u));
+
+  for (i = 0ul; i < node->attrs_count; i++)
+  {
+    attr = node->attrs[i];
+    dom_tape_push(self->tape, DOM_TAPE_ATTR, dom_tape_intern(self, attr->name, strlen(attr->name)),
+      dom_tape_store(self->tape, (attr->value == NULL) ? "" : attr->value, attr->vallen));
+  }
+
+  if (0ul < node->bodylen)
+  {
+    dom_tape_push(self->tape, DOM_TAPE_TEXT, 0u, dom_tape_store(self->tape, node->body, node->bodylen));
+  }
+}
+
+dom_tape_t *dom_tape_new(const dom_tree_t *tree)
+{
+  dom_tape_builder_t builder;
+  dom_trav_t *trav = NULL;
+  const dom_tree_node_t *node = NULL;
+
+  dom_tape_builder_setup(&builder);
+  strcpy(builder.doctype, tree->doctype);
+
+  trav = dom_trav_new(DOM_TRAV_EULER);
+  dom_trav_reset(trav, tree->root);
+
+  while (NULL != (node = dom_trav_next(trav)))
+  {
+    if (trav->leave)
+    {
+      dom_tape_close_top(&builder);
+    }
+    else
+    {
+      dom_tape_enter(&builder, node);
+    }
+  }
+
+  dom_trav_destroy(trav);
+
+  return dom_tape_builder_finish(&builder);
+}
+
+static void dom_tape_on_doctype(void *ctx, const uint8_t *data, const size_t size)
+{
+  dom_tape_builder_t *self = (dom_tape_builder_t *)ctx;
+  const size_t room = sizeof(self->doctype) - 1ul - strlen(self->doctype);
+
+  strncat(self->doctype, (const char *)data, (size < room) ? size : room);
+}
+
+static void dom_tape_on_open(void *ctx, const uint8_t *name, const size_t size)
+{
+  dom_tape_builder_t *self = (dom_tape_builder_t *)ctx;
+
+  dom_tape_stack_push(self, dom_tape_push(self->tape, DOM_TAPE_OPEN, dom_tape_intern(self, name, size), 0u));
+}
+
+static void dom_tape_on_attr(void *ctx, const uint8_t *name, const size_t namelen, const uint8_t *value, const size_t vallen)
+{
+  dom_tape_builder_t *self = (dom_tape_builder_t *)ctx;
+
+  dom_tape_push(self->tape, DOM_TAPE_ATTR, dom_tape_intern(self, name, namelen), dom_tape_store(self->tape, value, vallen));
+}
+
+static void dom_tape_on_text(void *ctx, const uint8_t *data, const size_t size)
+{
+  dom_tape_builder_t *self = (dom_tape_builder_t *)ctx;
+  uint8_t *out = NULL;
+  size_t len;
+  size_t i;
+
+  if (0ul == self->top)
+  {
+    return;
+  }
+
+  // NOTE: Line-breaks are dropped, as they are from tree node bodies.
+  out = dom_tape_reserve(self->tape, size);
+  for (i = 0ul, len = 0ul; i < size; i++)
+  {
+    if (data[i] != '\n')
+    {
+      out[len++] = data[i];
+    }
+  }
+
+  if (0ul < len)
+  {
+    dom_tape_push(self->tape, DOM_TAPE_TEXT, 0u, dom_tape_commit(self->tape, len));
+  }
+}
+
+static void dom_tape_on_close(void *ctx, const uint8_t *name, const size_t size)
+{
+  dom_tape_builder_t *self = (dom_tape_builder_t *)ctx;
+
+  // NOTE: The document root stays open until the end, as it does when
+  //       building tree nodes.
+  if (1ul >= self->top)
+  {
+    return;
+  }
+
+  if (!dom_tape_name_eq(self->tape, self->names[DOM_TAPE_NAME_ID(self->tape->entries[self->stack[self->top - 1ul]])], name, size))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "closing tag name does not match open tag name");
+    exit(EXIT_FAILURE);
+  }
+
+  dom_tape_close_top(self);
+}
+
+static const html_walker_t dom_tape_walker = {
+  &dom_tape_on_doctype,
+  &dom_tape_on_open,
+  &dom_tape_on_attr,
+  NULL,
+  &dom_tape_on_text,
+  &dom_tape_on_close,
+};
+
+dom_tape_t *dom_tape_parse(const void *data, const size_t size)
+{
+  dom_tape_builder_t builder;
+  html_scan_t *scan = NULL;
+
+  dom_tape_builder_setup(&builder);
+
+  scan = html_scan(html_scan_new(HTML_SCAN_CAPACITY), data, size);
+  if (HTML_WALK_TEXT != html_walk(scan, data, size, &dom_tape_walker, &builder))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+    exit(EXIT_FAILURE);
+  }
+  html_scan_destroy(scan);
+
+  if (1ul != builder.top)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "incomplete");
+    exit(EXIT_FAILURE);
+  }
+  dom_tape_close_top(&builder);
+
+  return dom_tape_builder_finish(&builder);
+}
+
+int dom_tape_type(const dom_tape_t *self, const uint64_t i)
+{
+  return DOM_TAPE_TYPE(self->entries[i]);
+}
+
+uint64_t dom_tape_next(const dom_tape_t *self, const uint64_t i)
+{
+  if (DOM_TAPE_OPEN == DOM_TAPE_TYPE(self->entries[i]))
+  {
+    return 1ul + DOM_TAPE_VALUE(self->entries[i]);
+  }
+  return 1ul + i;
+}
+
+uint64_t dom_tape_first_child(const dom_tape_t *self, const uint64_t i)
+{
+  uint64_t j;
+
+  for (j = 1ul + i; DOM_TAPE_ATTR == DOM_TAPE_TYPE(self->entries[j]); j++);
+
+  return j;
+}
+
+const char *dom_tape_string(const dom_tape_t *self, const uint32_t offset, size_t *len)
+{
+  uint32_t size;
+
+  memcpy(&size, self->strings + offset, sizeof(size));
+  if (len != NULL)
+  {
+    *len = size;
+  }
+  return (const char *)(self->strings + offset + sizeof(size));
+}
+
+const char *dom_tape_name(const dom_tape_t *self, const uint64_t i, size_t *len)
+{
+  const uint64_t names = 1ul + DOM_TAPE_VALUE(self->entries[0]);
+  const uint64_t name = self->entries[names + DOM_TAPE_NAME_ID(self->entries[i])];
+
+  return dom_tape_string(self, DOM_TAPE_VALUE(name), len);
+}
+
+const char *dom_tape_text(const dom_tape_t *self, const uint64_t i, size_t *len)
+{
+  return dom_tape_string(self, DOM_TAPE_VALUE(self->entries[i]), len);
+}
+
+const char *dom_tape_attribute(const dom_tape_t *self, const uint64_t i, const char *name, size_t *len)
+{
+  uint64_t j;
+
+  for (j = 1ul + i; DOM_TAPE_ATTR == DOM_TAPE_TYPE(self->entries[j]); j++)
+  {
+    if (0 == strcmp(dom_tape_name(self, j, NULL), name))
+    {
+      return dom_tape_text(self, j, len);
+    }
+  }
+
+  return NULL;
+}
+
+uint64_t dom_tape_get_element_by_name(const dom_tape_t *self, const char *name)
+{
+  const uint64_t end = DOM_TAPE_VALUE(self->entries[0]);
+  uint64_t i;
+
+  for (i = 2ul; i < end; i++)
+  {
+    if (DOM_TAPE_OPEN == DOM_TAPE_TYPE(self->entries[i]) && 0 == strcmp(dom_tape_name(self, i, NULL), name))
+    {
+      return i;
+    }
+  }
+
+  return 0ul;
+}
+
+void dom_tape_serialize(const dom_tape_t *self, dom_buffer_t *sink)
+{
+  const uint64_t end = DOM_TAPE_VALUE(self->entries[0]);
+  const char *data = NULL;
+  size_t size;
+  uint64_t i;
+  bool raw;
+
+  raw = false;
+
+  for (i = 1ul; i < end; i++)
+  {
+    switch (DOM_TAPE_TYPE(self->entries[i]))
+    {
+      case DOM_TAPE_DOCTYPE:
+        data = dom_tape_text(self, i, &size);
+        dom_buffer_write(sink, "<!", 2ul);
+        dom_buffer_write(sink, data, size);
+        dom_buffer_write(sink, ">", 1ul);
+        break;
+
+      case DOM_TAPE_OPEN:
+        data = dom_tape_name(self, i, &size);
+        raw = dom_serialize_is_raw(data, size);
+        dom_buffer_write(sink, "<", 1ul);
+        dom_buffer_write(sink, data, size);
+        if (DOM_TAPE_ATTR != DOM_TAPE_TYPE(self->entries[i + 1ul]))
+        {
+          dom_buffer_write(sink, ">", 1ul);
+        }
+        break;
+
+      case DOM_TAPE_ATTR:
+        data = dom_tape_name(self, i, &size);
+        dom_buffer_write(sink, " ", 1ul);
+        dom_buffer_write(sink, data, size);
+        dom_buffer_write(sink, "=\"", 2ul);
+        data = dom_tape_text(self, i, &size);
+        dom_buffer_write_value(sink, data, size);
+        dom_buffer_write(sink, "\"", 1ul);
+        if (DOM_TAPE_ATTR != DOM_TAPE_TYPE(self->entries[i + 1ul]))
+        {
+          dom_buffer_write(sink, ">", 1ul);
+        }
+        break;
+
+      case DOM_TAPE_TEXT:
+        data = dom_tape_text(self, i, &size);
+        if (raw)
+        {
+          dom_buffer_write(sink, data, size);
+        }
+        else
+        {
+          dom_buffer_write_text(sink, data, size);
+        }
+        break;
+
+      case DOM_TAPE_CLOSE:
+        data = dom_tape_name(self, i, &size);
+        raw = false;
+        dom_buffer_write(sink, "</", 2ul);
+        dom_buffer_write(sink, data, size);
+        dom_buffer_write(sink, ">", 1ul);
+        break;
+
+      default:
+        fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown entry type", DOM_TAPE_TYPE(self->entries[i]));
+        exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void dom_tape_print(const dom_tape_t *self)
+{
+  dom_buffer_t *out = NULL;
+
+  out = dom_buffer_new_sink(DOM_BUFFER_CAPACITY, &dom_buffer_fwrite, stdout);
+  dom_tape_serialize(self, out);
+  dom_buffer_destroy(out);
+}
+
+void dom_tape_BFS(const dom_tape_t *self)
+{
+  graph_builder_t *builder = NULL;
+  graph_t *graph = NULL;
+  uint64_t *que = NULL;
+  uint64_t r;
+  uint64_t w;
+  uint64_t i;
+  uint64_t j;
+  uint64_t k;
+  uint64_t first;
+  uint64_t end;
+  uint64_t depth;
+  uint64_t tmp;
+  uint32_t child;
+  const char *name = NULL;
+  size_t len;
+
+  if (DOM_TAPE_OPEN != DOM_TAPE_TYPE(self->entries[2]))
+  {
+    return;
+  }
+
+  builder = graph_builder_new();
+
+  // NOTE: Every element is queued at most once, so the queue never
+  //       needs more room than the tape has entries. Its position in
+  //       the queue is its vertex.
+  que = (uint64_t *)malloc(self->count * sizeof(*que));
+  if (que == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  r = w = 0ul;
+  que[w++] = 2ul;
+  name = dom_tape_name(self, 2ul, &len);
+  graph_builder_add_vertex(builder, name, len);
+
+  depth = 0ul;
+  end = w;
+
+  while (r < w)
+  {
+    if (r == end)
+    {
+      depth++;
+      end = w;
+    }
+
+    i = que[r++];
+    first = w;
+
+    // NOTE: Children are found last to first, walking back from the
+    //       CLOSE entry and jumping over each child subtree, so they
+    //       are put back in order before becoming vertices.
+    for (j = DOM_TAPE_VALUE(self->entries[i]) - 1ul; j > i; j--)
+    {
+      if (DOM_TAPE_CLOSE != DOM_TAPE_TYPE(self->entries[j]))
+      {
+        continue;
+      }
+
+      j = DOM_TAPE_VALUE(self->entries[j]);
+      que[w++] = j;
+    }
+
+    for (j = first, k = w; j + 1ul < k; j++, k--)
+    {
+      tmp = que[j];
+      que[j] = que[k - 1ul];
+      que[k - 1ul] = tmp;
+    }
+
+    for (j = first; j < w; j++)
+    {
+      name = dom_tape_name(self, que[j], &len);
+      child = graph_builder_add_vertex(builder, name, len);
+      graph_builder_add_edge(builder, (uint32_t)(r - 1ul), child, (int32_t)depth);
+    }
+  }
+
+  graph = graph_builder_finish(builder);
+  graph_BFS(graph, 0u);
+
+  free(que);
+  graph_destroy(graph);
+  graph_builder_destroy(builder);
+}
@@ -0,0 +1,133 @@
+#ifndef TAPE_H
+#define TAPE_H
+
+#include "serial.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_TAPE_CAPACITY         (1ul << 10)
+#define DOM_TAPE_STRINGS_CAPACITY (1ul << 12)
+
+/**
+ * @brief Entry types, stored in the top byte of every tape entry.
+ */
+enum
+{
+  DOM_TAPE_ROOT    = 'r',
+  DOM_TAPE_DOCTYPE = 'd',
+  DOM_TAPE_OPEN    = '<',
+  DOM_TAPE_ATTR    = 'a',
+  DOM_TAPE_TEXT    = 't',
+  DOM_TAPE_CLOSE   = '>',
+  DOM_TAPE_NAME    = 'n',
+};
+
+#define DOM_TAPE_TYPE(e)    ((int)((e) >> 56))
+#define DOM_TAPE_NAME_ID(e) ((uint32_t)(((e) >> 32) & 0xfffffful))
+#define DOM_TAPE_VALUE(e)   ((uint32_t)((e) & 0xfffffffful))
+
+/**
+ * @brief A document flattened into one array of 64 bit entries and one
+ *        string buffer. Each entry packs a type, a 24 bit name id and a
+ *        32 bit value:
+ *
+ *          ROOT     index of the other ROOT entry
+ *          DOCTYPE  string offset
+ *          OPEN     name id, index of the matching CLOSE
+ *          ATTR     name id, string offset of the value
+ *          TEXT     string offset
+ *          CLOSE    name id, index of the matching OPEN
+ *          NAME     string offset
+ *
+ *        The document sits between the two ROOT entries, the first of
+ *        which is followed by the DOCTYPE. The NAME entries follow the
+ *        last ROOT entry, one per name id. Strings are stored as a 32
+ *        bit length, the bytes and a terminating NUL.
+ */
+struct dom_tape
+{
+  size_t cap;
+  uint64_t count;
+  size_t strcap;
+  uint64_t strsize;
+  uint64_t *entries;
+  uint8_t *strings;
+  void *map;
+  size_t mapsize;
+};
+
+typedef struct dom_tape dom_tape_t;
+
+/**
+ * @brief Flatten a parsed tree into a tape.
+ */
+dom_tape_t *dom_tape_new(const dom_tree_t *tree);
+
+/**
+ * @brief Parse a document straight into a tape without building tree
+ *        nodes.
+ */
+dom_tape_t *dom_tape_parse(const void *data, const size_t size);
+
+void dom_tape_destroy(dom_tape_t *self);
+
+/**
+ * @brief Write the tape to disk as a header followed by the entries and
+ *        the strings. Returns zero on success.
+ */
+int dom_tape_save(const dom_tape_t *self, const char *path);
+
+/**
+ * @brief Flatten a parsed tree and write it to disk. Returns zero on
+ *        success.
+ */
+int dom_tree_save(const dom_tree_t *tree, const char *path);
+
+/**
+ * @brief Map a saved document read-only. The returned tape points into
+ *        the mapping, so nothing is copied or decoded; it is released
+ *        with dom_tape_destroy(). Returns NULL on failure.
+ */
+dom_tape_t *dom_tree_load_mmap(const char *path);
+
+int dom_tape_type(const dom_tape_t *self, const uint64_t i);
+
+/**
+ * @brief Return the index after the entry, skipping the whole subtree
+ *        when the entry is an OPEN.
+ */
+uint64_t dom_tape_next(const dom_tape_t *self, const uint64_t i);
+
+/**
+ * @brief Return the index of the first child of an OPEN entry, which is
+ *        the index of its CLOSE when it has none.
+ */
+uint64_t dom_tape_first_child(const dom_tape_t *self, const uint64_t i);
+
+const char *dom_tape_string(const dom_tape_t *self, const uint32_t offset, size_t *len);
+
+const char *dom_tape_name(const dom_tape_t *self, const uint64_t i, size_t *len);
+
+/**
+ * @brief Return the string held by a DOCTYPE, ATTR or TEXT entry.
+ */
+const char *dom_tape_text(const dom_tape_t *self, const uint64_t i, size_t *len);
+
+const char *dom_tape_attribute(const dom_tape_t *self, const uint64_t i, const char *name, size_t *len);
+
+/**
+ * @brief Return the index of the first element with the name, or zero
+ *        when there is none.
+ */
+uint64_t dom_tape_get_element_by_name(const dom_tape_t *self, const char *name);
+
+void dom_tape_serialize(const dom_tape_t *self, dom_buffer_t *sink);
+
+void dom_tape_print(const dom_tape_t *self);
+
+void dom_tape_BFS(const dom_tape_t *self);
+
+#endif/*TAPE_H*/
@@ -0,0 +1,256 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "bloom.h"
+#include "node.h"
+#include "trav.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+dom_trav_t *dom_trav_new(const int order)
+{
+  dom_trav_t *self = NULL;
+  self = (dom_trav_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->order = order;
+  self->cap = DOM_TRAV_CAPACITY;
+  self->frames = (dom_trav_frame_t *)malloc(self->cap * sizeof(*self->frames));
+  if (self->frames == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  return self;
+}
+
+void dom_trav_destroy(dom_trav_t *self)
+{
+  if (self != NULL)
+  {
+    dom_bloom_destroy(self->bloom);
+    self->bloom = NULL;
+
+    if (self->frames != NULL)
+    {
+      free(self->frames);
+      self->frames = NULL;
+    }
+
+    free(self);
+    self = NULL;
+  }
+}
+
+static void dom_trav_push(dom_trav_t *self, dom_tree_node_t *node, const uint64_t next)
+{
+  if (self->w >= self->cap)
+  {
+    // NOTE: A BFS queue drains from the front, so reclaim that space
+    //       before growing.
+    if (0ul < self->r)
+    {
+      memmove(self->frames, self->frames + self->r, (self->w - self->r) * sizeof(*self->frames));
+      self->w -= self->r;
+      self->r = 0ul;
+    }
+
+    if (self->w >= self->cap)
+    {
+      void *__old = self->frames;
+      self->frames = NULL;
+      self->frames = (dom_trav_frame_t *)realloc(__old, (self->cap << 1) * sizeof(*self->frames));
+      if (self->frames == NULL)
+      {
+        fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+        exit(EXIT_FAILURE);
+      }
+      self->cap <<= 1;
+    }
+  }
+
+  self->frames[self->w].node = node;
+  self->frames[self->w].next = next;
+  self->w++;
+}
+
+void dom_trav_track_ancestors(dom_trav_t *self)
+{
+  if (self->bloom == NULL)
+  {
+    self->bloom = dom_bloom_new();
+  }
+}
+
+void dom_trav_reset(dom_trav_t *self, const dom_tree_node_t *node)
+{
+  const dom_tree_node_t *anc = NULL;
+
+  self->r = self->w = 0ul;
+  self->depth = 0ul;
+  self->leave = false;
+  self->entered = false;
+
+  if (node == NULL)
+  {
+    return;
+  }
+
+  if (self->bloom != NULL)
+  {
+    dom_bloom_clear(self->bloom);
+    for (anc = node->parent; anc != NULL; anc = anc->parent)
+    {
+      dom_bloom_push(self->bloom, anc);
+    }
+  }
+
+  // NOTE: Depth first frames hold the index of the next child to
+  //       visit, which starts out past the end so the first step
+  //       reports the start node itself. BFS frames hold the depth.
+  dom_trav_push(self, (dom_tree_node_t *)node, (DOM_TRAV_BFS == self->order) ? 0ul : UINT64_MAX);
+}
+
+/**
+ * @brief Step the depth first walk by one enter or leave event.
+ */
+static dom_tree_node_t *dom_trav_step(dom_trav_t *self)
+{
+  dom_trav_frame_t *frame = NULL;
+  dom_tree_node_t *node = NULL;
+
+  if (0ul == self->w)
+  {
+    return NULL;
+  }
+
+  frame = self->frames + (self->w - 1ul);
+
+  // NOTE: A node joins the filter only after it has been reported, so
+  //       the filter holds exactly the ancestors of the node reported.
+  //       Leaves are never anyone's ancestor and stay out of it.
+  if (self->entered && 0ul < frame->node->count)
+  {
+    dom_bloom_push(self->bloom, frame->node);
+  }
+  self->entered = false;
+
+  if (UINT64_MAX == frame->next)
+  {
+    frame->next = 0ul;
+    self->leave = false;
+    self->entered = (self->bloom != NULL);
+    self->depth = self->w - 1ul;
+    if (frame->node->children != NULL)
+    {
+      __builtin_prefetch(frame->node->children[0]);
+    }
+    return frame->node;
+  }
+
+  while (frame->next < frame->node->count && frame->node->children[frame->next] == NULL)
+  {
+    frame->next++;
+  }
+
+  if (frame->next < frame->node->count)
+  {
+    node = frame->node->children[frame->next++];
+
+    if (frame->next < frame->node->count)
+    {
+      __builtin_prefetch(frame->node->children[frame->next]);
+    }
+    if (node->children != NULL)
+    {
+      __builtin_prefetch(node->children[0]);
+    }
+
+    dom_trav_push(self, node, 0ul);
+    self->leave = false;
+    self->entered = (self->bloom != NULL);
+    self->depth = self->w - 1ul;
+    return node;
+  }
+
+  if (self->bloom != NULL && 0ul < frame->node->count)
+  {
+    dom_bloom_pop(self->bloom);
+  }
+
+  self->w--;
+  self->leave = true;
+  self->depth = self->w;
+  return frame->node;
+}
+
+static dom_tree_node_t *dom_trav_next_bfs(dom_trav_t *self)
+{
+  dom_tree_node_t *node = NULL;
+  uint64_t i;
+
+  if (self->r == self->w)
+  {
+    return NULL;
+  }
+
+  node = self->frames[self->r].node;
+  self->depth = self->frames[self->r].next;
+  self->r++;
+
+  for (i = 0ul; i < node->count; i++)
+  {
+    if (node->children[i] != NULL)
+    {
+      __builtin_prefetch(node->children[i]);
+      dom_trav_push(self, node->children[i], 1ul + self->depth);
+    }
+  }
+
+  return node;
+}
+
+dom_tree_node_t *dom_trav_next(dom_trav_t *self)
+{
+  dom_tree_node_t *node = NULL;
+
+  switch (self->order)
+  {
+    case DOM_TRAV_PREORDER:
+      while (NULL != (node = dom_trav_step(self)) && self->leave);
+      return node;
+
+    case DOM_TRAV_POSTORDER:
+      while (NULL != (node = dom_trav_step(self)) && !self->leave);
+      return node;
+
+    case DOM_TRAV_EULER:
+      return dom_trav_step(self);
+
+    case DOM_TRAV_BFS:
+      return dom_trav_next_bfs(self);
+
+    default:
+      fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown traversal order", self->order);
+      exit(EXIT_FAILURE);
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef TRAV_H
+#define TRAV_H
+
+#include "bloom.h"
+#include "node.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOM_TRAV_CAPACITY (1ul << 6)
+
+/**
+ * @brief Visiting orders. EULER reports every element twice, once on
+ *        the way down and once on the way back up.
+ */
+enum
+{
+  DOM_TRAV_PREORDER,
+  DOM_TRAV_POSTORDER,
+  DOM_TRAV_EULER,
+  DOM_TRAV_BFS,
+};
+
+struct dom_trav_frame
+{
+  dom_tree_node_t *node;
+  uint64_t next;
+};
+
+typedef struct dom_trav_frame dom_trav_frame_t;
+
+/**
+ * @brief Iterator over a tree of nodes. Depth first orders keep the path
+ *        from the start node in an explicit stack, BFS keeps the queue
+ *        in the same array, so neither recurses and one iterator can be
+ *        reset and reused across walks.
+ */
+struct dom_trav
+{
+  int order;
+  bool leave;
+  bool entered;
+  uint64_t depth;
+  dom_bloom_t *bloom;
+  size_t cap;
+  uint64_t r;
+  uint64_t w;
+  dom_trav_frame_t *frames;
+};
+
+typedef struct dom_trav dom_trav_t;
+
+dom_trav_t *dom_trav_new(const int order);
+
+void dom_trav_destroy(dom_trav_t *self);
+
+/**
+ * @brief Keep a Bloom filter of the ancestors of the current node in
+ *        'bloom' during depth first walks, for selector matching to
+ *        reject nodes without looking up the tree.
+ */
+void dom_trav_track_ancestors(dom_trav_t *self);
+
+/**
+ * @brief Start a new walk from the node.
+ */
+void dom_trav_reset(dom_trav_t *self, const dom_tree_node_t *node);
+
+/**
+ * @brief Return the next node, or NULL once the walk is done. After
+ *        each call 'depth' holds the node's depth below the start node
+ *        and, for EULER walks, 'leave' tells whether the node is being
+ *        left rather than entered.
+ */
+dom_tree_node_t *dom_trav_next(dom_trav_t *self);
+
+#endif/*TRAV_H*/
@@ -10,6 +10,9 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "attrmap.h"
+#include "serial.h"
+#include "tag.h"
 #include "tree.h"
 
 #include <stddef.h>
@@ -32,6 +35,18 @@ void dom_tree_destroy(dom_tree_t *self)
 {
   if (self != NULL)
   {
+    dom_tag_index_destroy(self->index);
+    self->index = NULL;
+
+    dom_attr_map_destroy(self->ids);
+    self->ids = NULL;
+
+    dom_attr_map_destroy(self->classes);
+    self->classes = NULL;
+
+    dom_tree_node_list_destroy(self->nodes);
+    self->nodes = NULL;
+
     free(self);
     self = NULL;
   }
@@ -44,6 +59,10 @@ void dom_tree_print(const dom_tree_t *self)
     fprintf(stderr, "%s(): %s", __func__, "null pointer exception");
     exit(EXIT_FAILURE);
   }
-  printf("<!%s>", self->doctype);
-  __dom_tree_node_print(self->root);
+
+  dom_buffer_t *out = NULL;
+
+  out = dom_buffer_new_sink(DOM_BUFFER_CAPACITY, &dom_buffer_fwrite, stdout);
+  dom_tree_serialize(self, out);
+  dom_buffer_destroy(out);
 }
@@ -3,9 +3,23 @@
 
 #include "node.h"
 
+#include <stdint.h>
+
+#define DOM_TREE_INDEX_TAGS  (1 << 0)
+#define DOM_TREE_INDEX_ATTRS (1 << 1)
+
+struct dom_attr_map;
+struct dom_tag_index;
+
 struct dom_tree
 {
   char doctype[256];
+  int flags;
+  uint64_t count;
+  struct dom_tag_index *index;
+  struct dom_attr_map *ids;
+  struct dom_attr_map *classes;
+  dom_tree_node_list_t *nodes;
   dom_tree_node_t *root;
 };
 
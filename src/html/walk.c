@@ -0,0 +1,354 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "scan.h"
+#include "walk.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static const char *const html_void_tags[] = {
+  "area", "base", "br", "col", "embed", "hr", "img", "input",
+  "link", "meta", "param", "source", "track", "wbr", NULL,
+};
+
+static const char *const html_raw_tags[] = {
+  "script", "style", NULL,
+};
+
+static bool html_walk_name_eq(const uint8_t *name, const size_t size, const char *other)
+{
+  size_t i;
+
+  for (i = 0ul; i < size; i++)
+  {
+    if (other[i] == '\0' || tolower(name[i]) != other[i])
+    {
+      return false;
+    }
+  }
+
+  return other[i] == '\0';
+}
+
+static bool html_walk_name_in(const uint8_t *name, const size_t size, const char *const *list)
+{
+  for (; *list != NULL; list++)
+  {
+    if (html_walk_name_eq(name, size, *list))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Advance the index cursor to the first structural character
+ *        'ch' at or after 'from'. Returns 'size' when there is none.
+ */
+static size_t html_walk_seek(const html_scan_t *scan, const uint8_t *data, const size_t size, uint64_t *k, const size_t from, const uint8_t ch)
+{
+  while (*k < scan->count && (scan->pos[*k] < from || data[scan->pos[*k]] != ch))
+  {
+    *k += 1ul;
+  }
+  return (*k < scan->count) ? (size_t)scan->pos[*k] : size;
+}
+
+static void html_walk_text(const html_walker_t *walker, void *ctx, const uint8_t *data, const size_t from, const size_t to)
+{
+  if (to > from && walker->text != NULL)
+  {
+    walker->text(ctx, data + from, to - from);
+  }
+}
+
+/**
+ * @brief Find the '<' opening the closing tag of a raw text element.
+ */
+static size_t html_walk_raw_end(const html_scan_t *scan, const uint8_t *data, const size_t size, uint64_t *k, size_t from, const uint8_t *name, const size_t namelen)
+{
+  size_t p;
+  size_t i;
+
+  for (;;)
+  {
+    p = html_walk_seek(scan, data, size, k, from, '<');
+    if (p >= size)
+    {
+      return size;
+    }
+
+    if ((p + 2ul + namelen) < size && data[p + 1ul] == '/')
+    {
+      for (i = 0ul; i < namelen && tolower(data[p + 2ul + i]) == tolower(name[i]); i++);
+
+      if (i == namelen && (data[p + 2ul + i] == '>' || isspace(data[p + 2ul + i])))
+      {
+        return p;
+      }
+    }
+
+    from = p + 1ul;
+  }
+}
+
+int html_walk(const html_scan_t *scan, const uint8_t *data, const size_t size, const html_walker_t *walker, void *ctx)
+{
+  const uint8_t *name = NULL;
+  size_t namelen;
+  size_t text;
+  size_t from;
+  size_t p;
+  size_t q;
+  size_t i;
+  size_t a;
+  size_t v;
+  size_t alen;
+  size_t vlen;
+  uint64_t k;
+  bool closed;
+
+  k = 0ul;
+  text = 0ul;
+  from = 0ul;
+
+  for (;;)
+  {
+    p = html_walk_seek(scan, data, size, &k, from, '<');
+    if (p >= size)
+    {
+      html_walk_text(walker, ctx, data, text, size);
+      return HTML_WALK_TEXT;
+    }
+
+    if ((p + 1ul) >= size)
+    {
+      html_walk_text(walker, ctx, data, text, p);
+      return HTML_WALK_TAG;
+    }
+
+    switch (data[p + 1ul])
+    {
+      case '/':
+        q = html_walk_seek(scan, data, size, &k, p, '>');
+        if (q >= size)
+        {
+          html_walk_text(walker, ctx, data, text, p);
+          return HTML_WALK_TAG;
+        }
+
+        html_walk_text(walker, ctx, data, text, p);
+
+        for (i = p + 2ul; i < q && !isspace(data[i]); i++);
+
+        if (walker->close != NULL)
+        {
+          walker->close(ctx, data + p + 2ul, i - (p + 2ul));
+        }
+
+        text = from = q + 1ul;
+        continue;
+
+      case '!':
+        html_walk_text(walker, ctx, data, text, p);
+
+        if ((p + 3ul) < size && data[p + 2ul] == '-' && data[p + 3ul] == '-')
+        {
+          // NOTE: A comment ends at the first "-->", which may be
+          //       preceded by any number of '>' inside the comment.
+          q = p + 4ul;
+          do
+          {
+            q = html_walk_seek(scan, data, size, &k, q, '>');
+            if (q >= size)
+            {
+              return HTML_WALK_TAG;
+            }
+            q++;
+          } while ((q - 1ul) < (p + 6ul) || data[q - 2ul] != '-' || data[q - 3ul] != '-');
+
+          text = from = q;
+          continue;
+        }
+
+        q = html_walk_seek(scan, data, size, &k, p, '>');
+        if (q >= size)
+        {
+          return HTML_WALK_TAG;
+        }
+
+        if (walker->doctype != NULL)
+        {
+          walker->doctype(ctx, data + p + 2ul, q - (p + 2ul));
+        }
+
+        text = from = q + 1ul;
+        continue;
+
+      default:
+        if (!isalpha(data[p + 1ul]))
+        {
+          // NOTE: A '<' that does not start a tag is body text.
+          from = p + 1ul;
+          continue;
+        }
+        break;
+    }
+
+    html_walk_text(walker, ctx, data, text, p);
+
+    name = data + p + 1ul;
+    for (i = p + 1ul; i < size && !isspace(data[i]) && data[i] != '>' && data[i] != '/'; i++);
+    if (i >= size)
+    {
+      return HTML_WALK_TAG;
+    }
+    namelen = (size_t)((data + i) - name);
+
+    if (walker->open != NULL)
+    {
+      walker->open(ctx, name, namelen);
+    }
+
+    closed = false;
+
+    for (;;)
+    {
+      while (i < size && isspace(data[i]))
+      {
+        i++;
+      }
+
+      if (i >= size)
+      {
+        return HTML_WALK_TAG;
+      }
+
+      if (data[i] == '>')
+      {
+        i++;
+        break;
+      }
+
+      if (data[i] == '/')
+      {
+        if ((i + 1ul) < size && data[i + 1ul] == '>')
+        {
+          closed = true;
+          i += 2ul;
+          break;
+        }
+        i++;
+        continue;
+      }
+
+      a = i;
+      while (i < size && !isspace(data[i]) && data[i] != '=' && data[i] != '>' && data[i] != '/')
+      {
+        i++;
+      }
+      alen = i - a;
+
+      while (i < size && isspace(data[i]))
+      {
+        i++;
+      }
+
+      v = i;
+      vlen = 0ul;
+
+      if (i < size && data[i] == '=')
+      {
+        i++;
+        while (i < size && isspace(data[i]))
+        {
+          i++;
+        }
+
+        if (i >= size)
+        {
+          return HTML_WALK_TAG;
+        }
+
+        if (data[i] == '"')
+        {
+          q = html_walk_seek(scan, data, size, &k, i + 1ul, '"');
+          if (q >= size)
+          {
+            return HTML_WALK_TAG;
+          }
+          v = i + 1ul;
+          vlen = q - v;
+          i = q + 1ul;
+        }
+        else if (data[i] == '\'')
+        {
+          const uint8_t *end = memchr(data + i + 1ul, '\'', size - (i + 1ul));
+          if (end == NULL)
+          {
+            return HTML_WALK_TAG;
+          }
+          v = i + 1ul;
+          vlen = (size_t)(end - (data + v));
+          i = v + vlen + 1ul;
+        }
+        else
+        {
+          v = i;
+          while (i < size && !isspace(data[i]) && data[i] != '>')
+          {
+            i++;
+          }
+          vlen = i - v;
+        }
+      }
+
+      if (alen > 0ul && walker->attr != NULL)
+      {
+        walker->attr(ctx, data + a, alen, data + v, vlen);
+      }
+    }
+
+    if (walker->open_end != NULL)
+    {
+      walker->open_end(ctx);
+    }
+
+    text = from = i;
+
+    if (closed || html_walk_name_in(name, namelen, html_void_tags))
+    {
+      if (walker->close != NULL)
+      {
+        walker->close(ctx, name, namelen);
+      }
+      continue;
+    }
+
+    if (html_walk_name_in(name, namelen, html_raw_tags))
+    {
+      q = html_walk_raw_end(scan, data, size, &k, i, name, namelen);
+      if (q >= size)
+      {
+        html_walk_text(walker, ctx, data, i, size);
+        return HTML_WALK_RAW;
+      }
+      html_walk_text(walker, ctx, data, i, q);
+      text = from = q;
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef WALK_H
+#define WALK_H
+
+#include "scan.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTML_WALK_TEXT 0
+#define HTML_WALK_TAG  1
+#define HTML_WALK_RAW  2
+
+typedef void (*html_span_t)(void *, const uint8_t *, const size_t);
+
+typedef void (*html_attr_t)(void *, const uint8_t *, const size_t, const uint8_t *, const size_t);
+
+typedef void (*html_event_t)(void *);
+
+struct html_walker
+{
+  html_span_t doctype;
+  html_span_t open;
+  html_attr_t attr;
+  html_event_t open_end;
+  html_span_t text;
+  html_span_t close;
+};
+
+typedef struct html_walker html_walker_t;
+
+/**
+ * @brief Walk the structural index of a buffer and report each doctype,
+ *        tag, attribute and text run to the walker. Returns the state the
+ *        buffer ended in: HTML_WALK_TEXT when it ended between tags.
+ */
+int html_walk(const html_scan_t *scan, const uint8_t *data, const size_t size, const html_walker_t *walker, void *ctx);
+
+#endif/*WALK_H*/
@@ -0,0 +1,870 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "attr.h"
+#include "mem.h"
+#include "node.h"
+#include "query.h"
+#include "tree.h"
+#include "xpath.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct xpath_parser
+{
+  const char *p;
+  xpath_plan_t *plan;
+};
+
+typedef struct xpath_parser xpath_parser_t;
+
+static xpath_plan_t *xpath_plan_new(void)
+{
+  xpath_plan_t *self = NULL;
+  self = (xpath_plan_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = self->predcap = XPATH_PLAN_CAPACITY;
+  self->strcap = XPATH_STRINGS_CAPACITY;
+  self->steps = (xpath_step_t *)mem_grow(NULL, self->cap * sizeof(*self->steps));
+  self->preds = (xpath_pred_t *)mem_grow(NULL, self->predcap * sizeof(*self->preds));
+  self->strings = (char *)mem_grow(NULL, self->strcap * sizeof(*self->strings));
+  return self;
+}
+
+void xpath_plan_destroy(xpath_plan_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->steps);
+    free(self->preds);
+    free(self->strings);
+    free(self);
+    self = NULL;
+  }
+}
+
+static xpath_step_t *xpath_plan_step(xpath_plan_t *self, const int axis, const int test)
+{
+  xpath_step_t *step = NULL;
+
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->steps = (xpath_step_t *)mem_grow(self->steps, self->cap * sizeof(*self->steps));
+  }
+
+  step = self->steps + self->count++;
+  memset(step, 0, sizeof(*step));
+  step->axis = axis;
+  step->test = test;
+  step->pred = self->npred;
+  return step;
+}
+
+static xpath_pred_t *xpath_plan_pred(xpath_plan_t *self, const int op)
+{
+  xpath_pred_t *pred = NULL;
+
+  if (self->npred >= self->predcap)
+  {
+    self->predcap <<= 1;
+    self->preds = (xpath_pred_t *)mem_grow(self->preds, self->predcap * sizeof(*self->preds));
+  }
+
+  pred = self->preds + self->npred++;
+  memset(pred, 0, sizeof(*pred));
+  pred->op = op;
+  return pred;
+}
+
+static uint32_t xpath_plan_store(xpath_plan_t *self, const char *data, const size_t size, const bool lower)
+{
+  const uint32_t offset = (uint32_t)self->strsize;
+  size_t i;
+
+  if ((self->strsize + size + 1ul) > self->strcap)
+  {
+    while ((self->strsize + size + 1ul) > self->strcap)
+    {
+      self->strcap <<= 1;
+    }
+    self->strings = (char *)mem_grow(self->strings, self->strcap * sizeof(*self->strings));
+  }
+
+  for (i = 0ul; i < size; i++)
+  {
+    self->strings[offset + i] = lower ? (char)tolower((unsigned char)data[i]) : data[i];
+  }
+  self->strings[offset + size] = '\0';
+  self->strsize += size + 1ul;
+  return offset;
+}
+
+static void xpath_skip_space(xpath_parser_t *self)
+{
+  while (isspace((unsigned char)*self->p))
+  {
+    self->p++;
+  }
+}
+
+static bool xpath_accept(xpath_parser_t *self, const char *word)
+{
+  const size_t len = strlen(word);
+
+  xpath_skip_space(self);
+  if (0 != strncmp(self->p, word, len))
+  {
+    return false;
+  }
+  self->p += len;
+  xpath_skip_space(self);
+  return true;
+}
+
+static size_t xpath_name(xpath_parser_t *self, const char **start)
+{
+  *start = self->p;
+  while (isalnum((unsigned char)*self->p) || *self->p == '-' || *self->p == '_' || *self->p == ':' || *self->p == '.')
+  {
+    self->p++;
+  }
+  return (size_t)(self->p - *start);
+}
+
+/**
+ * @brief Parse a quoted literal into the plan's strings.
+ */
+static bool xpath_literal(xpath_parser_t *self, xpath_pred_t *pred)
+{
+  const char quote = *self->p;
+  const char *start = NULL;
+
+  if (quote != '"' && quote != '\'')
+  {
+    return false;
+  }
+
+  start = ++self->p;
+  while (*self->p != '\0' && *self->p != quote)
+  {
+    self->p++;
+  }
+  if (*self->p != quote)
+  {
+    return false;
+  }
+
+  pred->value = xpath_plan_store(self->plan, start, (size_t)(self->p - start), false);
+  pred->vallen = (uint32_t)(self->p - start);
+  self->p++;
+  xpath_skip_space(self);
+  return true;
+}
+
+/**
+ * @brief Parse what a predicate compares: '@name' or text().
+ */
+static bool xpath_operand(xpath_parser_t *self, xpath_pred_t *pred)
+{
+  const char *start = NULL;
+  size_t len;
+
+  if (xpath_accept(self, "text()"))
+  {
+    pred->text = true;
+    return true;
+  }
+
+  if (*self->p != '@')
+  {
+    return false;
+  }
+
+  self->p++;
+  len = xpath_name(self, &start);
+  if (len == 0ul)
+  {
+    return false;
+  }
+
+  pred->name = xpath_plan_store(self->plan, start, len, false);
+  xpath_skip_space(self);
+  return true;
+}
+
+/**
+ * @brief Parse the arguments of a string function, whose name and open
+ *        parenthesis have been consumed.
+ */
+static bool xpath_pred_call(xpath_parser_t *self, const int op)
+{
+  xpath_pred_t *pred = NULL;
+
+  pred = xpath_plan_pred(self->plan, op);
+  return xpath_operand(self, pred) && xpath_accept(self, ",") && xpath_literal(self, pred) && xpath_accept(self, ")");
+}
+
+static bool xpath_pred(xpath_parser_t *self, xpath_step_t *step)
+{
+  xpath_pred_t *pred = NULL;
+  char *end = NULL;
+
+  xpath_skip_space(self);
+
+  if (isdigit((unsigned char)*self->p))
+  {
+    pred = xpath_plan_pred(self->plan, XPATH_PRED_POSITION);
+    pred->pos = strtol(self->p, &end, 10);
+    self->p = end;
+    step->positional = true;
+  }
+  else if (xpath_accept(self, "last()"))
+  {
+    pred = xpath_plan_pred(self->plan, XPATH_PRED_LAST);
+    step->positional = true;
+  }
+  else if (xpath_accept(self, "starts-with("))
+  {
+    if (!xpath_pred_call(self, XPATH_PRED_STARTS_WITH))
+    {
+      return false;
+    }
+  }
+  else if (xpath_accept(self, "contains("))
+  {
+    if (!xpath_pred_call(self, XPATH_PRED_CONTAINS))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    pred = xpath_plan_pred(self->plan, XPATH_PRED_EXISTS);
+    if (!xpath_operand(self, pred))
+    {
+      return false;
+    }
+
+    if (xpath_accept(self, "!="))
+    {
+      pred->op = XPATH_PRED_NOT_EQUALS;
+    }
+    else if (xpath_accept(self, "="))
+    {
+      pred->op = XPATH_PRED_EQUALS;
+    }
+
+    if (pred->op != XPATH_PRED_EXISTS && !xpath_literal(self, pred))
+    {
+      return false;
+    }
+  }
+
+  step->npred++;
+  return xpath_accept(self, "]");
+}
+
+static bool xpath_step(xpath_parser_t *self)
+{
+  static const struct { const char *name; int axis; } axes[] = {
+    { "child::",              XPATH_AXIS_CHILD },
+    { "descendant-or-self::", XPATH_AXIS_DESCENDANT_OR_SELF },
+    { "descendant::",         XPATH_AXIS_DESCENDANT },
+    { "parent::",             XPATH_AXIS_PARENT },
+    { "following-sibling::",  XPATH_AXIS_FOLLOWING_SIBLING },
+    { "self::",               XPATH_AXIS_SELF },
+  };
+  xpath_step_t *step = NULL;
+  const char *start = NULL;
+  size_t len;
+  size_t i;
+  int axis;
+
+  if (0 == strncmp(self->p, "..", 2ul))
+  {
+    self->p += 2;
+    xpath_plan_step(self->plan, XPATH_AXIS_PARENT, XPATH_TEST_NODE);
+    return true;
+  }
+
+  if (*self->p == '.')
+  {
+    self->p++;
+    xpath_plan_step(self->plan, XPATH_AXIS_SELF, XPATH_TEST_NODE);
+    return true;
+  }
+
+  axis = XPATH_AXIS_CHILD;
+  for (i = 0ul; i < sizeof(axes) / sizeof(axes[0]); i++)
+  {
+    len = strlen(axes[i].name);
+    if (0 == strncmp(self->p, axes[i].name, len))
+    {
+      self->p += len;
+      axis = axes[i].axis;
+      break;
+    }
+  }
+
+  if (*self->p == '*')
+  {
+    self->p++;
+    step = xpath_plan_step(self->plan, axis, XPATH_TEST_ANY);
+  }
+  else if (0 == strncmp(self->p, "node()", 6ul))
+  {
+    self->p += 6;
+    step = xpath_plan_step(self->plan, axis, XPATH_TEST_NODE);
+  }
+  else if (0 == strncmp(self->p, "text()", 6ul))
+  {
+    self->p += 6;
+    step = xpath_plan_step(self->plan, axis, XPATH_TEST_TEXT);
+  }
+  else
+  {
+    len = xpath_name(self, &start);
+    if (len == 0ul)
+    {
+      return false;
+    }
+    step = xpath_plan_step(self->plan, axis, XPATH_TEST_NAME);
+    step->name = xpath_plan_store(self->plan, start, len, true);
+    step->namelen = (uint32_t)len;
+  }
+
+  while (*self->p == '[')
+  {
+    self->p++;
+    if (!xpath_pred(self, step))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+xpath_plan_t *xpath_compile(const char *expr)
+{
+  xpath_parser_t parser;
+  bool ok = true;
+
+  parser.p = expr;
+  parser.plan = xpath_plan_new();
+
+  xpath_skip_space(&parser);
+
+  // NOTE: '//' abbreviates '/descendant-or-self::node()/'.
+  if (0 == strncmp(parser.p, "//", 2ul))
+  {
+    parser.p += 2;
+    xpath_plan_step(parser.plan, XPATH_AXIS_DESCENDANT_OR_SELF, XPATH_TEST_NODE);
+  }
+  else if (*parser.p == '/')
+  {
+    parser.p++;
+  }
+
+  // NOTE: Only "/" itself may select the document alone.
+  ok = (*parser.p != '\0' || (0ul == parser.plan->count && parser.p > expr));
+
+  while (ok && *parser.p != '\0')
+  {
+    ok = xpath_step(&parser);
+    xpath_skip_space(&parser);
+
+    if (!ok || *parser.p == '\0')
+    {
+      break;
+    }
+
+    if (0 == strncmp(parser.p, "//", 2ul))
+    {
+      parser.p += 2;
+      xpath_plan_step(parser.plan, XPATH_AXIS_DESCENDANT_OR_SELF, XPATH_TEST_NODE);
+    }
+    else if (*parser.p == '/')
+    {
+      parser.p++;
+    }
+    else
+    {
+      ok = false;
+      break;
+    }
+
+    // NOTE: A path cannot end on a separator.
+    xpath_skip_space(&parser);
+    ok = (*parser.p != '\0');
+  }
+
+  if (ok && *parser.p != '\0')
+  {
+    ok = false;
+  }
+
+  if (!ok)
+  {
+    fprintf(stderr, "%s(): %s at offset %ld\n", __func__, "malformed expression", (long)(parser.p - expr));
+    xpath_plan_destroy(parser.plan);
+    return NULL;
+  }
+
+  return parser.plan;
+}
+
+/**
+ * @brief The state of one evaluation. Elements live in the lists; the
+ *        document, which has no element of its own, is a flag.
+ */
+struct xpath_eval
+{
+  const xpath_plan_t *plan;
+  dom_tree_t *tree;
+  bool doc;
+  bool next_doc;
+  dom_tree_node_list_t *ctx;
+  dom_tree_node_list_t *next;
+  dom_tree_node_list_t *cand;
+};
+
+typedef struct xpath_eval xpath_eval_t;
+
+static bool xpath_name_equals(const char *name, const size_t namelen, const dom_tree_node_t *node)
+{
+  size_t i;
+
+  if (namelen != node->namelen)
+  {
+    return false;
+  }
+
+  for (i = 0ul; i < namelen; i++)
+  {
+    if (name[i] != (char)tolower((unsigned char)node->name[i]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool xpath_test(const xpath_plan_t *plan, const xpath_step_t *step, const dom_tree_node_t *node)
+{
+  switch (step->test)
+  {
+    case XPATH_TEST_NAME:
+      return xpath_name_equals(plan->strings + step->name, step->namelen, node);
+
+    case XPATH_TEST_TEXT:
+      return 0ul < node->bodylen;
+
+    default:
+      return true;
+  }
+}
+
+static bool xpath_contains(const char *data, const size_t size, const char *needle, const size_t len)
+{
+  size_t i;
+
+  if (len > size)
+  {
+    return false;
+  }
+
+  for (i = 0ul; i + len <= size; i++)
+  {
+    if (0 == memcmp(data + i, needle, len))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Test a predicate on the candidate at 'pos', counting from one,
+ *        of the 'count' the step selected from one context node.
+ */
+static bool xpath_pred_test(const xpath_plan_t *plan, const xpath_pred_t *pred, const dom_tree_node_t *node, const uint64_t pos, const uint64_t count)
+{
+  const dom_tree_node_attr_t *attr = NULL;
+  const char *value = plan->strings + pred->value;
+  const char *data = NULL;
+  size_t size = 0ul;
+
+  switch (pred->op)
+  {
+    case XPATH_PRED_POSITION:
+      return (int64_t)pos == pred->pos;
+
+    case XPATH_PRED_LAST:
+      return pos == count;
+
+    default:
+      break;
+  }
+
+  if (pred->text)
+  {
+    if (0ul == node->bodylen)
+    {
+      return false;
+    }
+    data = node->body;
+    size = node->bodylen;
+  }
+  else
+  {
+    attr = dom_tree_node_get_attribute(node, plan->strings + pred->name);
+    if (attr == NULL)
+    {
+      return false;
+    }
+    data = attr->value;
+    size = attr->vallen;
+  }
+
+  switch (pred->op)
+  {
+    case XPATH_PRED_EQUALS:
+      return size == pred->vallen && 0 == memcmp(data, value, size);
+
+    case XPATH_PRED_NOT_EQUALS:
+      return size != pred->vallen || 0 != memcmp(data, value, size);
+
+    case XPATH_PRED_CONTAINS:
+      return xpath_contains(data, size, value, pred->vallen);
+
+    case XPATH_PRED_STARTS_WITH:
+      return size >= pred->vallen && 0 == memcmp(data, value, pred->vallen);
+
+    default:
+      return true;
+  }
+}
+
+/**
+ * @brief Filter the candidates of one context node through the step's
+ *        predicates in turn, each seeing the positions left by the last,
+ *        and move the survivors to the next context.
+ */
+static void xpath_eval_filter(xpath_eval_t *self, const xpath_step_t *step)
+{
+  dom_tree_node_list_t *cand = self->cand;
+  const xpath_pred_t *pred = NULL;
+  uint64_t count;
+  uint64_t i;
+  uint64_t j;
+  uint64_t k;
+
+  for (k = 0ul; k < step->npred; k++)
+  {
+    pred = self->plan->preds + step->pred + k;
+    count = cand->count;
+
+    for (i = j = 0ul; i < count; i++)
+    {
+      if (xpath_pred_test(self->plan, pred, cand->nodes[i], i + 1ul, count))
+      {
+        cand->nodes[j++] = cand->nodes[i];
+      }
+    }
+
+    cand->count = j;
+  }
+
+  for (i = 0ul; i < cand->count; i++)
+  {
+    self->next = dom_tree_node_list_append(self->next, cand->nodes[i]);
+  }
+
+  cand->count = 0ul;
+}
+
+static void xpath_eval_candidate(xpath_eval_t *self, const xpath_step_t *step, dom_tree_node_t *node)
+{
+  if (xpath_test(self->plan, step, node))
+  {
+    self->cand = dom_tree_node_list_append(self->cand, node);
+  }
+}
+
+static void xpath_eval_descendants(xpath_eval_t *self, const xpath_step_t *step, const dom_tree_node_t *node)
+{
+  dom_tree_node_t **nodes = NULL;
+  uint64_t n;
+  uint64_t i;
+
+  nodes = dom_tree_get_descendants(self->tree, node, &n);
+  for (i = 0ul; i < n; i++)
+  {
+    xpath_eval_candidate(self, step, nodes[i]);
+  }
+}
+
+/**
+ * @brief Select along the step's axis from the document.
+ */
+static void xpath_eval_doc(xpath_eval_t *self, const xpath_step_t *step, const int axis)
+{
+  dom_tree_node_t *root = self->tree->root;
+
+  // NOTE: The document is no element, so only node() with nothing to
+  //       filter by keeps it.
+  if ((XPATH_AXIS_SELF == axis || XPATH_AXIS_DESCENDANT_OR_SELF == axis) && XPATH_TEST_NODE == step->test && 0ul == step->npred)
+  {
+    self->next_doc = true;
+  }
+
+  switch (axis)
+  {
+    case XPATH_AXIS_CHILD:
+      if (XPATH_TEST_TEXT != step->test)
+      {
+        xpath_eval_candidate(self, step, root);
+      }
+      break;
+
+    case XPATH_AXIS_DESCENDANT:
+    case XPATH_AXIS_DESCENDANT_OR_SELF:
+      xpath_eval_candidate(self, step, root);
+      xpath_eval_descendants(self, step, root);
+      break;
+
+    default:
+      break;
+  }
+
+  xpath_eval_filter(self, step);
+}
+
+/**
+ * @brief Select along the step's axis from every context element. When
+ *        positions do not matter, the contexts whose selections an
+ *        earlier context already covered are skipped: descendants of an
+ *        expanded node, and later siblings of one.
+ */
+static void xpath_eval_step(xpath_eval_t *self, const xpath_step_t *step, const int axis)
+{
+  const dom_tree_node_t *last = NULL;
+  dom_tree_node_t *parent = NULL;
+  dom_tree_node_t *node = NULL;
+  uint64_t i;
+  uint64_t j;
+
+  self->next->count = 0ul;
+  self->next_doc = false;
+
+  if (self->doc)
+  {
+    xpath_eval_doc(self, step, axis);
+    if (!step->positional && (XPATH_AXIS_DESCENDANT == axis || XPATH_AXIS_DESCENDANT_OR_SELF == axis))
+    {
+      return;
+    }
+  }
+
+  for (i = 0ul; i < self->ctx->count; i++)
+  {
+    node = self->ctx->nodes[i];
+
+    switch (axis)
+    {
+      case XPATH_AXIS_CHILD:
+        // NOTE: Text lives in the element body, so an element stands in
+        //       for its own text children.
+        if (XPATH_TEST_TEXT == step->test)
+        {
+          xpath_eval_candidate(self, step, node);
+          break;
+        }
+
+        for (j = 0ul; j < node->count; j++)
+        {
+          xpath_eval_candidate(self, step, node->children[j]);
+        }
+        break;
+
+      case XPATH_AXIS_DESCENDANT:
+      case XPATH_AXIS_DESCENDANT_OR_SELF:
+        if (!step->positional && last != NULL && dom_tree_node_is_ancestor(last, node))
+        {
+          break;
+        }
+        last = node;
+
+        if (XPATH_AXIS_DESCENDANT_OR_SELF == axis)
+        {
+          xpath_eval_candidate(self, step, node);
+        }
+        xpath_eval_descendants(self, step, node);
+        break;
+
+      case XPATH_AXIS_PARENT:
+        if (node->parent != NULL)
+        {
+          xpath_eval_candidate(self, step, node->parent);
+        }
+        else if (XPATH_TEST_NODE == step->test && 0ul == step->npred)
+        {
+          self->next_doc = true;
+        }
+        break;
+
+      case XPATH_AXIS_FOLLOWING_SIBLING:
+        parent = node->parent;
+        if (parent == NULL || (!step->positional && last == parent))
+        {
+          break;
+        }
+        last = parent;
+
+        for (j = 0ul; j < parent->count && parent->children[j] != node; j++)
+        {
+        }
+
+        for (j++; j < parent->count; j++)
+        {
+          xpath_eval_candidate(self, step, parent->children[j]);
+        }
+        break;
+
+      case XPATH_AXIS_SELF:
+        xpath_eval_candidate(self, step, node);
+        break;
+
+      default:
+        fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown axis", axis);
+        exit(EXIT_FAILURE);
+    }
+
+    xpath_eval_filter(self, step);
+  }
+}
+
+static int xpath_compare(const void *a, const void *b)
+{
+  const dom_tree_node_t *x = *(const dom_tree_node_t *const *)a;
+  const dom_tree_node_t *y = *(const dom_tree_node_t *const *)b;
+
+  return (x->pre > y->pre) - (x->pre < y->pre);
+}
+
+/**
+ * @brief Put the next context in document order without duplicates,
+ *        leaving it alone when the step already produced it that way.
+ */
+static void xpath_eval_order(dom_tree_node_list_t *list)
+{
+  uint64_t i;
+  uint64_t j;
+
+  for (i = 1ul; i < list->count && list->nodes[i - 1ul]->pre < list->nodes[i]->pre; i++)
+  {
+  }
+
+  if (i >= list->count)
+  {
+    return;
+  }
+
+  qsort(list->nodes, list->count, sizeof(*list->nodes), &xpath_compare);
+
+  for (i = j = 1ul; i < list->count; i++)
+  {
+    if (list->nodes[i] != list->nodes[j - 1ul])
+    {
+      list->nodes[j++] = list->nodes[i];
+    }
+  }
+
+  list->count = j;
+}
+
+dom_tree_node_list_t *xpath_eval(const xpath_plan_t *plan, dom_tree_t *tree, dom_tree_node_list_t *results)
+{
+  const xpath_step_t *step = NULL;
+  dom_tree_node_list_t *swap = NULL;
+  xpath_eval_t self;
+  uint64_t i;
+  int axis;
+
+  if (tree->root == NULL)
+  {
+    return results;
+  }
+
+  if (tree->nodes == NULL)
+  {
+    dom_tree_number(tree);
+  }
+
+  self.plan = plan;
+  self.tree = tree;
+  self.doc = true;
+  self.next_doc = false;
+  self.ctx = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+  self.next = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+  self.cand = dom_tree_node_list_new(DOM_TREE_NODE_LIST_CAPACITY);
+
+  for (i = 0ul; i < plan->count && (self.doc || 0ul < self.ctx->count); i++)
+  {
+    step = plan->steps + i;
+    axis = step->axis;
+
+    // NOTE: descendant-or-self::node()/child::x selects what
+    //       descendant::x does as long as positions are not involved,
+    //       and walks each subtree once instead of once per node.
+    if (XPATH_AXIS_DESCENDANT_OR_SELF == axis && XPATH_TEST_NODE == step->test && 0ul == step->npred && i + 1ul < plan->count &&
+        XPATH_AXIS_CHILD == step[1].axis && XPATH_TEST_TEXT != step[1].test && !step[1].positional)
+    {
+      step++;
+      i++;
+      axis = XPATH_AXIS_DESCENDANT;
+    }
+
+    xpath_eval_step(&self, step, axis);
+    xpath_eval_order(self.next);
+
+    swap = self.ctx;
+    self.ctx = self.next;
+    self.next = swap;
+    self.doc = self.next_doc;
+  }
+
+  for (i = 0ul; i < self.ctx->count; i++)
+  {
+    results = dom_tree_node_list_append(results, self.ctx->nodes[i]);
+  }
+
+  dom_tree_node_list_destroy(self.ctx);
+  dom_tree_node_list_destroy(self.next);
+  dom_tree_node_list_destroy(self.cand);
+  return results;
+}
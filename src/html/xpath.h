@@ -0,0 +1,113 @@
+#ifndef XPATH_H
+#define XPATH_H
+
+#include "node.h"
+#include "tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define XPATH_PLAN_CAPACITY    (1ul << 3)
+#define XPATH_STRINGS_CAPACITY (1ul << 7)
+
+enum
+{
+  XPATH_AXIS_CHILD,
+  XPATH_AXIS_DESCENDANT,
+  XPATH_AXIS_DESCENDANT_OR_SELF,
+  XPATH_AXIS_PARENT,
+  XPATH_AXIS_FOLLOWING_SIBLING,
+  XPATH_AXIS_SELF,
+};
+
+enum
+{
+  XPATH_TEST_NAME,
+  XPATH_TEST_ANY,  /* *      */
+  XPATH_TEST_NODE, /* node() */
+  XPATH_TEST_TEXT, /* text() */
+};
+
+enum
+{
+  XPATH_PRED_POSITION,    /* [2]                     */
+  XPATH_PRED_LAST,        /* [last()]                */
+  XPATH_PRED_EXISTS,      /* [@a] [text()]           */
+  XPATH_PRED_EQUALS,      /* [@a='v'] [text()='v']   */
+  XPATH_PRED_NOT_EQUALS,  /* [@a!='v']               */
+  XPATH_PRED_CONTAINS,    /* [contains(@a,'v')]      */
+  XPATH_PRED_STARTS_WITH, /* [starts-with(@a,'v')]   */
+};
+
+/**
+ * @brief A predicate tests an attribute, or the element's text when
+ *        'text' is set, or its position among the nodes the step has
+ *        selected so far from the same context node.
+ */
+struct xpath_pred
+{
+  int op;
+  bool text;
+  uint32_t name;
+  uint32_t value;
+  uint32_t vallen;
+  int64_t pos;
+};
+
+typedef struct xpath_pred xpath_pred_t;
+
+struct xpath_step
+{
+  int axis;
+  int test;
+  uint32_t name;
+  uint32_t namelen;
+  uint64_t pred;
+  uint64_t npred;
+  bool positional;
+};
+
+typedef struct xpath_step xpath_step_t;
+
+/**
+ * @brief A compiled location path: its steps, the predicates they refer
+ *        to by index and the strings those refer to by offset. A plan
+ *        holds no document state and can be evaluated on any tree.
+ */
+struct xpath_plan
+{
+  size_t cap;
+  uint64_t count;
+  xpath_step_t *steps;
+  size_t predcap;
+  uint64_t npred;
+  xpath_pred_t *preds;
+  size_t strcap;
+  uint64_t strsize;
+  char *strings;
+};
+
+typedef struct xpath_plan xpath_plan_t;
+
+/**
+ * @brief Compile a location path such as "//div[@class='r']/a[1]".
+ *        Supports the child, descendant, descendant-or-self, parent,
+ *        following-sibling and self axes with their abbreviations, name,
+ *        '*', node() and text() tests, and attribute, text and position
+ *        predicates. Relative paths start from the document as well.
+ *        Returns NULL when the expression is malformed.
+ */
+xpath_plan_t *xpath_compile(const char *expr);
+
+void xpath_plan_destroy(xpath_plan_t *self);
+
+/**
+ * @brief Append the elements the plan selects to the results, in
+ *        document order. The tree is numbered first if it is not. The
+ *        text() test selects the elements owning text, since element
+ *        bodies stand in for text nodes.
+ */
+dom_tree_node_list_t *xpath_eval(const xpath_plan_t *plan, dom_tree_t *tree, dom_tree_node_list_t *results);
+
+#endif/*XPATH_H*/
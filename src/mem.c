@@ -0,0 +1,30 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "mem.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void *mem_grow(void *ptr, const size_t size)
+{
+  void *__old = ptr;
+  ptr = NULL;
+  ptr = realloc(__old, size);
+  if (ptr == NULL && size != 0ul)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
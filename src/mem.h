@@ -0,0 +1,20 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Resize a heap block, or allocate one when 'ptr' is NULL, and
+ *        exit on failure.
+ */
+void *mem_grow(void *ptr, const size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif/*MEM_H*/
@@ -0,0 +1,104 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "task.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct task
+{
+  task_func_t call;
+  uint8_t *args;
+  size_t size;
+  uint64_t n;
+  uint64_t next;
+};
+
+typedef struct task task_t;
+
+uint64_t task_cpu_count(void)
+{
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return (n < 1l) ? 1ul : (uint64_t)n;
+}
+
+/**
+ * @brief Claim argument records one at a time until none are left, so
+ *        uneven records balance themselves across the threads.
+ */
+static void *task_work(void *arg)
+{
+  task_t *self = (task_t *)arg;
+  uint64_t i;
+
+  while ((i = __atomic_fetch_add(&self->next, 1ul, __ATOMIC_RELAXED)) < self->n)
+  {
+    self->call(self->args + (i * self->size));
+  }
+
+  return NULL;
+}
+
+void task_run(task_func_t call, void *args, const size_t size, const uint64_t n, uint64_t nthreads)
+{
+  pthread_t threads[TASK_THREADS_MAX];
+  task_t self;
+  uint64_t i;
+
+  if (nthreads == 0ul)
+  {
+    nthreads = task_cpu_count();
+  }
+
+  if (nthreads > n)
+  {
+    nthreads = n;
+  }
+
+  if (nthreads > TASK_THREADS_MAX)
+  {
+    nthreads = TASK_THREADS_MAX;
+  }
+
+  self.call = call;
+  self.args = (uint8_t *)args;
+  self.size = size;
+  self.n = n;
+  self.next = 0ul;
+
+  for (i = 1ul; i < nthreads; i++)
+  {
+    if (0 != pthread_create(&threads[i], NULL, &task_work, &self))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not create thread");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  task_work(&self);
+
+  for (i = 1ul; i < nthreads; i++)
+  {
+    if (0 != pthread_join(threads[i], NULL))
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "could not join thread");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
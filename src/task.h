@@ -0,0 +1,32 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TASK_THREADS_MAX (1ul << 6)
+
+typedef void (*task_func_t)(void *);
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Return the number of online processors.
+ */
+uint64_t task_cpu_count(void);
+
+/**
+ * @brief Call the function once for each of the 'n' argument records
+ *        of 'size' bytes, spread over up to 'nthreads' threads. The
+ *        calling thread takes part; a zero thread count means one per
+ *        online processor.
+ */
+void task_run(task_func_t call, void *args, const size_t size, const uint64_t n, uint64_t nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif/*TASK_H*/
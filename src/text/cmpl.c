@@ -10,21 +10,21 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
-#include "lex.h"
+#include "cmpl.h"
 #include "parse.h"
-#include "token.h"
 #include "tree.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 content_tree_t *text_compile(const char *data)
 {
-  content_tree_t *tree = NULL;
-  token_queue_t  *que  = NULL;
+  if (data == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "null pointer exception");
+    exit(EXIT_FAILURE);
+  }
 
-  que  = text_lex(data);
-  tree = text_parse(que);
-
-  token_queue_destroy(que);
-  return tree;
+  return text_parse(data, strlen(data));
 }
@@ -0,0 +1,397 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "dedup.h"
+#include "mem.h"
+#include "tree.h"
+#include "vocab.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_DEDUP_SEED 0x9e3779b97f4a7c15ul
+
+static uint64_t text_dedup_mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ul;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebul;
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t *text_shingles(const content_tree_t *tree, const uint64_t k, uint64_t *n)
+{
+  const content_tree_node_t **stack = NULL;
+  const content_tree_node_t *node = NULL;
+  const content_word_t *word = NULL;
+  uint64_t *hashes = NULL;
+  char *buf = NULL;
+  size_t stackcap = CONTENT_TREE_NODE_QUEUE_CAPACITY;
+  size_t cap = TEXT_LSH_CAPACITY;
+  size_t bufcap = 0ul;
+  uint64_t top = 0ul;
+  uint64_t count = 0ul;
+  uint64_t hash;
+  uint64_t i;
+  uint64_t j;
+
+  stack = (const content_tree_node_t **)mem_grow(NULL, stackcap * sizeof(*stack));
+  hashes = (uint64_t *)mem_grow(NULL, cap * sizeof(*hashes));
+
+  if (tree != NULL && tree->root != NULL)
+  {
+    stack[top++] = tree->root;
+  }
+
+  // NOTE: Hash every word in document order, which is a preorder walk
+  //       with the children pushed last to first.
+  while (top > 0ul)
+  {
+    node = stack[--top];
+
+    if ((count + node->nwords) > cap)
+    {
+      while ((count + node->nwords) > cap)
+      {
+        cap <<= 1;
+      }
+      hashes = (uint64_t *)mem_grow(hashes, cap * sizeof(*hashes));
+    }
+
+    for (i = 0ul; i < node->nwords; i++)
+    {
+      word = node->words + i;
+
+      if (word->size > bufcap)
+      {
+        bufcap = (word->size + 63ul) & ~63ul;
+        buf = (char *)mem_grow(buf, bufcap);
+      }
+
+      text_lower(buf, (const char *)node->data + word->offset, word->size);
+      hashes[count++] = text_hash(buf, word->size);
+    }
+
+    if ((top + node->count) > stackcap)
+    {
+      while ((top + node->count) > stackcap)
+      {
+        stackcap <<= 1;
+      }
+      stack = (const content_tree_node_t **)mem_grow(stack, stackcap * sizeof(*stack));
+    }
+
+    for (i = node->count; i > 0ul; i--)
+    {
+      if (node->children[i - 1ul] != NULL)
+      {
+        stack[top++] = node->children[i - 1ul];
+      }
+    }
+  }
+
+  free(stack);
+  free(buf);
+
+  // NOTE: Fold each window of 'k' word hashes into its shingle in place;
+  //       a window only reads the hashes at and after its own start.
+  *n = (count == 0ul) ? 0ul : ((count < k || k == 0ul) ? 1ul : (count - k + 1ul));
+
+  for (i = 0ul; i < *n; i++)
+  {
+    hash = TEXT_DEDUP_SEED;
+
+    for (j = i; j < count && (k == 0ul || j < i + k); j++)
+    {
+      hash = text_dedup_mix(hash ^ hashes[j]);
+    }
+
+    hashes[i] = hash;
+  }
+
+  return hashes;
+}
+
+void text_signature_compute(text_signature_t *self, const uint64_t *shingles, const uint64_t n)
+{
+  int32_t weights[64];
+  uint64_t h1;
+  uint64_t h2;
+  uint32_t v;
+  uint64_t i;
+  uint64_t j;
+
+  memset(weights, 0, sizeof(weights));
+  memset(self->minhash, 0xff, sizeof(self->minhash));
+  self->simhash = 0ul;
+  self->count = n;
+
+  // NOTE: The MinHash functions are taken as h1 + j * h2 of two hashes
+  //       of the shingle, which behaves as well as independent ones for
+  //       estimating similarity and costs one multiply each.
+  for (i = 0ul; i < n; i++)
+  {
+    h1 = text_dedup_mix(shingles[i]);
+    h2 = text_dedup_mix(shingles[i] ^ TEXT_DEDUP_SEED) | 1ul;
+
+    for (j = 0ul; j < 64ul; j++)
+    {
+      weights[j] += ((h1 >> j) & 1ul) ? 1 : -1;
+    }
+
+    for (j = 0ul; j < TEXT_MINHASH_SIZE; j++)
+    {
+      v = (uint32_t)((h1 + j * h2) >> 32);
+      if (v < self->minhash[j])
+      {
+        self->minhash[j] = v;
+      }
+    }
+  }
+
+  for (j = 0ul; j < 64ul; j++)
+  {
+    if (weights[j] > 0)
+    {
+      self->simhash |= (1ul << j);
+    }
+  }
+}
+
+double text_signature_similarity(const text_signature_t *a, const text_signature_t *b)
+{
+  uint64_t same = 0ul;
+  uint64_t j;
+
+  for (j = 0ul; j < TEXT_MINHASH_SIZE; j++)
+  {
+    same += (a->minhash[j] == b->minhash[j]);
+  }
+
+  return (double)same / (double)TEXT_MINHASH_SIZE;
+}
+
+uint32_t text_signature_distance(const text_signature_t *a, const text_signature_t *b)
+{
+  return (uint32_t)__builtin_popcountll(a->simhash ^ b->simhash);
+}
+
+static uint64_t text_lsh_key(const text_signature_t *sig, const uint64_t band)
+{
+  uint64_t key = text_dedup_mix(TEXT_DEDUP_SEED + band);
+  uint64_t j;
+
+  for (j = band * TEXT_LSH_ROWS; j < (band + 1ul) * TEXT_LSH_ROWS; j++)
+  {
+    key = text_dedup_mix(key ^ sig->minhash[j]);
+  }
+
+  return key;
+}
+
+text_lsh_t *text_lsh_new(const size_t cap)
+{
+  text_lsh_t *self = NULL;
+  self = (text_lsh_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->cap = (cap > 0ul) ? cap : TEXT_LSH_CAPACITY;
+  self->sigs = (text_signature_t *)mem_grow(NULL, self->cap * sizeof(*self->sigs));
+  self->next = (uint32_t *)mem_grow(NULL, self->cap * TEXT_LSH_BANDS * sizeof(*self->next));
+
+  self->slotcap = TEXT_LSH_CAPACITY;
+  while (self->slotcap < (self->cap * TEXT_LSH_BANDS) << 1)
+  {
+    self->slotcap <<= 1;
+  }
+
+  self->slots = (text_lsh_slot_t *)mem_grow(NULL, self->slotcap * sizeof(*self->slots));
+  memset(self->slots, 0xff, self->slotcap * sizeof(*self->slots));
+  return self;
+}
+
+void text_lsh_destroy(text_lsh_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->sigs);
+    self->sigs = NULL;
+
+    free(self->next);
+    self->next = NULL;
+
+    free(self->slots);
+    self->slots = NULL;
+
+    free(self);
+    self = NULL;
+  }
+}
+
+/**
+ * @brief Return the slot of the key, or the empty slot where it belongs.
+ */
+static text_lsh_slot_t *text_lsh_slot(const text_lsh_t *self, const uint64_t key)
+{
+  text_lsh_slot_t *slot = NULL;
+  uint64_t i;
+
+  for (i = key & (self->slotcap - 1ul);; i = (i + 1ul) & (self->slotcap - 1ul))
+  {
+    slot = self->slots + i;
+    if (slot->head == UINT32_MAX || slot->key == key)
+    {
+      return slot;
+    }
+  }
+}
+
+static void text_lsh_rehash(text_lsh_t *self)
+{
+  text_lsh_slot_t *old = self->slots;
+  const size_t cap = self->slotcap;
+  text_lsh_slot_t *slot = NULL;
+  uint64_t i;
+
+  self->slotcap <<= 1;
+  self->slots = (text_lsh_slot_t *)mem_grow(NULL, self->slotcap * sizeof(*self->slots));
+  memset(self->slots, 0xff, self->slotcap * sizeof(*self->slots));
+
+  // NOTE: Only the chain heads move; the chains run through 'next'.
+  for (i = 0ul; i < cap; i++)
+  {
+    if (old[i].head != UINT32_MAX)
+    {
+      slot = text_lsh_slot(self, old[i].key);
+      *slot = old[i];
+    }
+  }
+
+  free(old);
+}
+
+uint32_t text_lsh_add(text_lsh_t *self, const text_signature_t *sig)
+{
+  text_lsh_slot_t *slot = NULL;
+  uint64_t band;
+  uint64_t key;
+  uint32_t id;
+
+  if (self->count >= UINT32_MAX - 1ul)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "index full");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->count >= self->cap)
+  {
+    self->cap <<= 1;
+    self->sigs = (text_signature_t *)mem_grow(self->sigs, self->cap * sizeof(*self->sigs));
+    self->next = (uint32_t *)mem_grow(self->next, self->cap * TEXT_LSH_BANDS * sizeof(*self->next));
+  }
+
+  id = (uint32_t)self->count++;
+  memcpy(self->sigs + id, sig, sizeof(*sig));
+
+  for (band = 0ul; band < TEXT_LSH_BANDS; band++)
+  {
+    if (((self->nslots + 1ul) << 1) > self->slotcap)
+    {
+      text_lsh_rehash(self);
+    }
+
+    key = text_lsh_key(sig, band);
+    slot = text_lsh_slot(self, key);
+
+    if (slot->head == UINT32_MAX)
+    {
+      slot->key = key;
+      self->nslots++;
+    }
+
+    self->next[id * TEXT_LSH_BANDS + band] = slot->head;
+    slot->head = id;
+  }
+
+  return id;
+}
+
+static int text_lsh_compare(const void *a, const void *b)
+{
+  const uint32_t x = *(const uint32_t *)a;
+  const uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+uint64_t text_lsh_query(const text_lsh_t *self, const text_signature_t *sig, const double threshold, uint32_t *out, const uint64_t max)
+{
+  const text_lsh_slot_t *slot = NULL;
+  uint32_t *cand = NULL;
+  size_t cap = TEXT_LSH_BANDS;
+  uint64_t ncand = 0ul;
+  uint64_t found = 0ul;
+  uint64_t band;
+  uint64_t i;
+  uint32_t id;
+
+  cand = (uint32_t *)mem_grow(NULL, cap * sizeof(*cand));
+
+  for (band = 0ul; band < TEXT_LSH_BANDS; band++)
+  {
+    slot = text_lsh_slot(self, text_lsh_key(sig, band));
+
+    // NOTE: A chain holds every document with this band, and possibly
+    //       others whose band key collided; verification drops those.
+    for (id = slot->head; id != UINT32_MAX; id = self->next[id * TEXT_LSH_BANDS + band])
+    {
+      if (ncand >= cap)
+      {
+        cap <<= 1;
+        cand = (uint32_t *)mem_grow(cand, cap * sizeof(*cand));
+      }
+      cand[ncand++] = id;
+    }
+  }
+
+  qsort(cand, ncand, sizeof(*cand), &text_lsh_compare);
+
+  for (i = 0ul; i < ncand; i++)
+  {
+    if (i > 0ul && cand[i] == cand[i - 1ul])
+    {
+      continue;
+    }
+
+    if (text_signature_similarity(self->sigs + cand[i], sig) < threshold)
+    {
+      continue;
+    }
+
+    if (found < max)
+    {
+      out[found] = cand[i];
+    }
+    found++;
+  }
+
+  free(cand);
+  return found;
+}
@@ -0,0 +1,100 @@
+#ifndef TEXT_DEDUP_H
+#define TEXT_DEDUP_H
+
+#include "tree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEXT_SHINGLE_WORDS 4ul
+
+/**
+ * @brief MinHash values per signature, split into BANDS bands of ROWS
+ *        values each for the LSH index. Two documents whose shingles
+ *        have a Jaccard similarity s share a band with probability
+ *        1 - (1 - s^ROWS)^BANDS.
+ */
+#define TEXT_MINHASH_SIZE 128ul
+#define TEXT_LSH_BANDS    32ul
+#define TEXT_LSH_ROWS     (TEXT_MINHASH_SIZE / TEXT_LSH_BANDS)
+
+#define TEXT_LSH_CAPACITY    (1ul << 10)
+#define TEXT_DEDUP_THRESHOLD 0.8
+
+/**
+ * @brief Return the hashes of the k word shingles of the tree's words,
+ *        lowercased and taken in document order, and their number in
+ *        'n'. A tree of fewer than 'k' words makes one shingle of them.
+ */
+uint64_t *text_shingles(const content_tree_t *tree, const uint64_t k, uint64_t *n);
+
+struct text_signature
+{
+  uint64_t simhash;
+  uint64_t count;
+  uint32_t minhash[TEXT_MINHASH_SIZE];
+};
+
+typedef struct text_signature text_signature_t;
+
+/**
+ * @brief Sign a document by its shingles: a 64 bit SimHash and the
+ *        smallest value of each of TEXT_MINHASH_SIZE hash functions.
+ */
+void text_signature_compute(text_signature_t *self, const uint64_t *shingles, const uint64_t n);
+
+/**
+ * @brief Estimate the Jaccard similarity of two documents' shingles.
+ */
+double text_signature_similarity(const text_signature_t *a, const text_signature_t *b);
+
+/**
+ * @brief Return the number of bits in which the SimHashes differ.
+ */
+uint32_t text_signature_distance(const text_signature_t *a, const text_signature_t *b);
+
+struct text_lsh_slot
+{
+  uint64_t key;
+  uint32_t head;
+};
+
+typedef struct text_lsh_slot text_lsh_slot_t;
+
+/**
+ * @brief A banding index over the signatures added to it. Each band of
+ *        a signature is hashed into 'slots', which holds the last
+ *        document added under that key; 'next' chains every document's
+ *        band to the one added before it under the same key.
+ */
+struct text_lsh
+{
+  size_t cap;
+  uint64_t count;
+  text_signature_t *sigs;
+  uint32_t *next;
+  size_t slotcap;
+  uint64_t nslots;
+  text_lsh_slot_t *slots;
+};
+
+typedef struct text_lsh text_lsh_t;
+
+text_lsh_t *text_lsh_new(const size_t cap);
+
+void text_lsh_destroy(text_lsh_t *self);
+
+/**
+ * @brief Add a signature, returning its document id.
+ */
+uint32_t text_lsh_add(text_lsh_t *self, const text_signature_t *sig);
+
+/**
+ * @brief Write into 'out' the ids of up to 'max' documents that share a
+ *        band with the signature and whose estimated similarity is at
+ *        least 'threshold', in increasing order. Returns how many there
+ *        are, which may exceed 'max'.
+ */
+uint64_t text_lsh_query(const text_lsh_t *self, const text_signature_t *sig, const double threshold, uint32_t *out, const uint64_t max);
+
+#endif/*TEXT_DEDUP_H*/
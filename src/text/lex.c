@@ -12,6 +12,7 @@
  */
 #include "tree.h"
 #include "io.h"
+#include "lex.h"
 #include "token.h"
 
 #include <ctype.h>
@@ -20,7 +21,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_WORD_BUF 64
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// NOTE: Words are runs of dashes and of anything that is not
+//       punctuation, space or a control character.
+#define TEXT_LEX_WORD(c) ((c) == '-' || (!ispunct(c) && !isspace(c) && !iscntrl(c)))
 
 token_queue_t *text_lex(const char *data)
 {
@@ -31,19 +38,15 @@ token_queue_t *text_lex(const char *data)
   }
 
   token_queue_t *que = NULL;
-  token_t *tok = NULL;
-  char buf[MAX_WORD_BUF];
-  uint32_t i;
+  const char *p = NULL;
+  token_t tok;
 
   que = token_queue_new(TOKEN_QUEUE_CAPACITY);
 
   for (; *data; data++)
   {
-    tok = token_queue_current(que);
-    if (tok == NULL)
-    {
-      return que;
-    }
+    tok.data = NULL;
+    tok.size = 0ul;
 
     switch (*data)
     {
@@ -53,56 +56,44 @@ token_queue_t *text_lex(const char *data)
       case '[':
       case ']':
       case '\n':
-        break;
+        continue;
 
       case ' ':
-        tok->kind = KIND_SPACE;
+        tok.kind = KIND_SPACE;
         break;
 
       case '.':
-        tok->kind = KIND_PERIOD;
+        tok.kind = KIND_PERIOD;
         break;
 
       case '!':
-        tok->kind = KIND_EXCL;
+        tok.kind = KIND_EXCL;
         break;
 
       case ',':
-        tok->kind = KIND_COMMA;
+        tok.kind = KIND_COMMA;
         break;
 
       case ':':
-        tok->kind = KIND_COLON;
+        tok.kind = KIND_COLON;
         break;
 
       case ';':
-        tok->kind = KIND_SEMI_COLON;
+        tok.kind = KIND_SEMI_COLON;
         break;
 
       default:
-        if (*data == '-' || (!ispunct(*data) && !isspace(*data) && !iscntrl(*data)))
+        if (TEXT_LEX_WORD(*data))
         {
-          for (i = 0u; i < (MAX_WORD_BUF - 1) && *data && (*data == '-' || (!ispunct(*data) && !isspace(*data) && !iscntrl(*data))); data++)
-          {
-            buf[i++] = *data;
-          }
-          if (i >= (MAX_WORD_BUF - 1) && *data && (*data == '-' || (!ispunct(*data) && !isspace(*data) && !iscntrl(*data))))
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "could not write to word buffer, buffer full");
-            exit(EXIT_FAILURE);
-          }
-          data--;
-
-          tok->data = calloc(1u+i, sizeof(*buf));
-          if (tok->data == NULL)
-          {
-            fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-            exit(EXIT_FAILURE);
-          }
-          tok->size = 1u+i;
-          tok->kind = KIND_WORD;
-
-          memcpy(tok->data, buf, i);
+          // NOTE: The token refers to the word where it stands in the
+          //       text, which outlives the queue, instead of a copy.
+          for (p = data; *p && TEXT_LEX_WORD(*p); p++);
+
+          tok.kind = KIND_WORD;
+          tok.data = (void *)data;
+          tok.size = (size_t)(p - data);
+
+          data = p - 1;
           break;
         }
 
@@ -110,12 +101,91 @@ token_queue_t *text_lex(const char *data)
         exit(EXIT_FAILURE);
     }
 
-    if (false == token_queue_next(que))
+    que = token_queue_append(que, &tok);
+  }
+
+  return que;
+}
+
+uint64_t text_lex_block(const uint8_t *block, uint64_t *words, uint64_t *marks)
+{
+#if defined(__SSE2__)
+  const __m128i lower = _mm_set1_epi8(0x20);
+  uint64_t skip = 0ul;
+  uint64_t i;
+
+  *words = *marks = 0ul;
+
+  // NOTE: Outside ASCII every byte belongs to a word; inside it, words
+  //       are made of letters, digits and dashes. With the case bit set
+  //       a letter lies between 'a' and 'z', and the signed compares
+  //       leave the bytes above ASCII to the sign mask.
+  for (i = 0ul; i < TEXT_LEX_BLOCK; i += 16ul)
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+    const __m128i l = _mm_or_si128(v, lower);
+    const __m128i w = _mm_or_si128(
+      _mm_or_si128(
+        _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(l, _mm_set1_epi8('z' + 1))),
+        _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)))),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+    const __m128i m = _mm_or_si128(
+      _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('.')), _mm_cmpeq_epi8(v, _mm_set1_epi8('!'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')), _mm_cmpeq_epi8(v, _mm_set1_epi8(':')))),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8(';')));
+    const __m128i k = _mm_or_si128(
+      _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('(')))),
+      _mm_or_si128(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8(')')),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')), _mm_cmpeq_epi8(v, _mm_set1_epi8(']')))));
+
+    *words |= ((uint64_t)(uint16_t)_mm_movemask_epi8(_mm_or_si128(w, v))) << i;
+    *marks |= ((uint64_t)(uint16_t)_mm_movemask_epi8(m)) << i;
+    skip |= ((uint64_t)(uint16_t)_mm_movemask_epi8(k)) << i;
+  }
+
+  return ~(*words | *marks | skip);
+#else
+  uint64_t other = 0ul;
+  uint64_t i;
+
+  *words = *marks = 0ul;
+
+  for (i = 0ul; i < TEXT_LEX_BLOCK; i++)
+  {
+    switch (block[i])
     {
-      fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue token into token queue");
-      exit(EXIT_FAILURE);
+      case '"':
+      case '(':
+      case ')':
+      case '[':
+      case ']':
+      case '\n':
+      case ' ':
+        break;
+
+      case '.':
+      case '!':
+      case ',':
+      case ':':
+      case ';':
+        *marks |= (1ul << i);
+        break;
+
+      default:
+        if (TEXT_LEX_WORD((char)block[i]))
+        {
+          *words |= (1ul << i);
+          break;
+        }
+        other |= (1ul << i);
+        break;
     }
   }
 
-  return que;
+  return other;
+#endif
 }
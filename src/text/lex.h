@@ -3,6 +3,17 @@
 
 #include "token.h"
 
+#include <stdint.h>
+
+#define TEXT_LEX_BLOCK 64ul
+
 token_queue_t *text_lex(const char *data);
 
+/**
+ * @brief Classify one TEXT_LEX_BLOCK byte block into bitmaps of its word
+ *        bytes and of the marks that end a sentence. Returns a bitmap of
+ *        the bytes that are neither and that the lexer does not skip.
+ */
+uint64_t text_lex_block(const uint8_t *block, uint64_t *words, uint64_t *marks);
+
 #endif/*TEXT_LEX_H*/
@@ -10,98 +10,97 @@
  *
  * Licensed under the Academic Free License version 3.0.
  */
+#include "lex.h"
+#include "parse.h"
 #include "tree.h"
-#include "io.h"
-#include "token.h"
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-static content_tree_node_t *parse2(token_queue_t *que)
+content_tree_t *text_parse(const char *data, const size_t size)
 {
-  content_tree_node_t *parent = NULL;
+  content_tree_t *tree = NULL;
   content_tree_node_t *node = NULL;
-  token_t *tok = NULL;
+  const uint8_t *block = NULL;
+  uint8_t tail[TEXT_LEX_BLOCK];
+  uint64_t words;
+  uint64_t marks;
+  uint64_t other;
+  uint64_t edges;
+  uint64_t events;
+  uint64_t carry = 0ul;
+  uint64_t first = 0ul;
+  size_t start = 0ul;
+  size_t i;
+  size_t j;
 
-  parent = content_tree_node_new(NULL, 0ul, CONTENT_TREE_NODE_CAPACITY);
+  tree = content_tree_new();
+  tree->root = node = content_tree_node_new(data, size, CONTENT_TREE_NODE_CAPACITY);
 
-  while (NULL != (tok = token_queue_dequeue(que)))
+  // NOTE: The text is classified a block at a time, and a word starts or
+  //       ends wherever the word bitmap changes, so only the boundaries
+  //       and the marks are visited. Words go straight into the node and
+  //       each mark closes those seen since the last into a sentence.
+  for (i = 0ul; i < size; i += TEXT_LEX_BLOCK)
   {
-    switch (tok->kind)
-    {
-      case KIND_SPACE:
-        break;
-
-      case KIND_WORD:
-        node = content_tree_node_new(tok->data, tok->size, CONTENT_TREE_NODE_CAPACITY);
-        if (false == content_tree_node_append(parent, node))
-        {
-          fprintf(stderr, "%s(): %s\n", __func__, "could not append child node to parent node");
-          exit(EXIT_FAILURE);
-        }
-        break;
-
-      case KIND_PERIOD:
-      case KIND_EXCL:
-      case KIND_COMMA:
-      case KIND_COLON:
-      case KIND_SEMI_COLON:
-        fprintf(stderr, "%s(): %s(%d)\n", __func__, "illegal token.kind", tok->kind);
-        exit(EXIT_FAILURE);
+    block = (const uint8_t *)data + i;
 
-      default:
-        fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown token.kind", tok->kind);
-        exit(EXIT_FAILURE);
+    if ((size - i) < TEXT_LEX_BLOCK)
+    {
+      memset(tail, ' ', sizeof(tail));
+      memcpy(tail, block, size - i);
+      block = tail;
     }
-  }
-
-  return parent;
-}
 
-content_tree_t *text_parse(token_queue_t *que)
-{
-  content_tree_t *tree = NULL;
-  content_tree_node_t *node = NULL;
-  token_queue_t *new_que = NULL;
-  token_t *tok = NULL;
+    other = text_lex_block(block, &words, &marks);
+    if (other != 0ul)
+    {
+      fprintf(stderr, "%s(): %s (%c)\n", __func__, "illegal character", (char)block[__builtin_ctzll(other)]);
+      exit(EXIT_FAILURE);
+    }
 
-  tree = content_tree_new();
-  new_que = token_queue_new((1ul << 12));
-  tree->root = content_tree_node_new(NULL, 0ul, CONTENT_TREE_NODE_CAPACITY);
+    edges = words ^ ((words << 1) | carry);
+    carry = words >> 63;
+    events = edges | marks;
 
-  while (NULL != (tok = token_queue_dequeue(que)))
-  {
-    switch (tok->kind)
+    while (events != 0ul)
     {
-      case KIND_SPACE:
-      case KIND_WORD:
-        if (false == token_queue_enqueue_back(new_que, tok))
+      j = (size_t)__builtin_ctzll(events);
+
+      if (edges & (1ul << j))
+      {
+        if (words & (1ul << j))
         {
-          fprintf(stderr, "%s(): %s\n", __func__, "could not enqueue into token queue");
-          exit(EXIT_FAILURE);
+          start = i + j;
         }
-        break;
-
-      case KIND_PERIOD:
-      case KIND_EXCL:
-      case KIND_COMMA:
-      case KIND_COLON:
-      case KIND_SEMI_COLON:
-        node = parse2(new_que);
-        token_queue_destroy(new_que);
-        if (false == content_tree_node_append(tree->root, node))
+        else
         {
-          fprintf(stderr, "%s(): %s\n", __func__, "could not append child node to parent node");
-          exit(EXIT_FAILURE);
+          content_tree_node_add_word(node, start, i + j - start);
         }
-        new_que = token_queue_new((1ul << 12));
-        break;
+      }
+
+      if (marks & (1ul << j))
+      {
+        content_tree_node_end_sentence(node);
+        first = node->nwords;
+      }
 
-      default:
-        fprintf(stderr, "%s(): %s(%d)\n", __func__, "unknown token.kind", tok->kind);
-        exit(EXIT_FAILURE);
+      events &= events - 1ul;
     }
   }
 
+  if (carry != 0ul)
+  {
+    content_tree_node_add_word(node, start, size - start);
+  }
+
+  if (node->nwords > first)
+  {
+    content_tree_node_end_sentence(node);
+  }
+
   return tree;
 }
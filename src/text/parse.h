@@ -1,9 +1,15 @@
 #ifndef TEXT_PARSE_H
 #define TEXT_PARSE_H
 
-#include "token.h"
 #include "tree.h"
 
-content_tree_t *text_parse(token_queue_t *que);
+#include <stddef.h>
+
+/**
+ * @brief Parse the text into a node over it in a single pass. The words
+ *        are spans of 'data', grouped into sentences by the marks that
+ *        end them; words after the last mark make up a final sentence.
+ */
+content_tree_t *text_parse(const char *data, const size_t size);
 
 #endif/*TEXT_PARSE_H*/
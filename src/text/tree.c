@@ -19,17 +19,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void content_tree_node_setup(content_tree_node_t *self, const void *data, const size_t size, const size_t cap)
-{
-  if (data != NULL)
-  {
-    memcpy(self->data, data, size);
-  }
-
-  self->size = size;
-  self->cap  = cap;
-}
-
 content_tree_node_t *content_tree_node_new(const void *data, const size_t size, const size_t cap)
 {
   content_tree_node_t *self = NULL;
@@ -40,14 +29,9 @@ content_tree_node_t *content_tree_node_new(const void *data, const size_t size,
     exit(EXIT_FAILURE);
   }
 
-  self->data = (uint8_t *)calloc(size, sizeof(*self->data));
-  if (self->data == NULL)
-  {
-    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
-    exit(EXIT_FAILURE);
-  }
-
-  content_tree_node_setup(self, data, size, cap);
+  self->data = (const uint8_t *)data;
+  self->size = size;
+  self->cap  = cap;
   return self;
 }
 
@@ -55,10 +39,22 @@ void content_tree_node_destroy(content_tree_node_t *self)
 {
   if (self != NULL)
   {
-    if (self->data != NULL)
+    if (self->words != NULL)
     {
-      free(self->data);
-      self->data = NULL;
+      free(self->words);
+      self->words = NULL;
+    }
+
+    if (self->sentences != NULL)
+    {
+      free(self->sentences);
+      self->sentences = NULL;
+    }
+
+    if (self->children != NULL)
+    {
+      free(self->children);
+      self->children = NULL;
     }
 
     free(self);
@@ -74,22 +70,22 @@ bool content_tree_node_append(content_tree_node_t *self, content_tree_node_t *no
     exit(EXIT_FAILURE);
   }
 
-  if (self->count >= self->cap)
-  {
-    return false;
-  }
-
   node->parent = self;
 
   if (self->children == NULL)
   {
-    self->children = (content_tree_node_t **)calloc(1ul, sizeof(*self->children));
+    if (0ul == self->cap)
+    {
+      self->cap = CONTENT_TREE_NODE_CAPACITY;
+    }
+    self->children = (content_tree_node_t **)malloc(self->cap * sizeof(*self->children));
   }
-  else
+  else if (self->count >= self->cap)
   {
     void *__old = self->children;
     self->children = NULL;
-    self->children = (content_tree_node_t **)realloc(__old, (1ul + self->count) * sizeof(*self->children));
+    self->children = (content_tree_node_t **)realloc(__old, (self->cap << 1) * sizeof(*self->children));
+    self->cap <<= 1;
   }
 
   if (self->children == NULL)
@@ -102,10 +98,103 @@ bool content_tree_node_append(content_tree_node_t *self, content_tree_node_t *no
   return true;
 }
 
+void content_tree_node_add_word(content_tree_node_t *self, const size_t offset, const size_t size)
+{
+  if (offset > UINT32_MAX || size > (UINT32_MAX - offset))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "word span out of range");
+    exit(EXIT_FAILURE);
+  }
+
+  if (self->words == NULL)
+  {
+    self->wordcap = CONTENT_TREE_WORDS_CAPACITY;
+    self->words = (content_word_t *)malloc(self->wordcap * sizeof(*self->words));
+  }
+  else if (self->nwords >= self->wordcap)
+  {
+    void *__old = self->words;
+    self->words = NULL;
+    self->words = (content_word_t *)realloc(__old, (self->wordcap << 1) * sizeof(*self->words));
+    self->wordcap <<= 1;
+  }
+
+  if (self->words == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->words[self->nwords].offset = (uint32_t)offset;
+  self->words[self->nwords].size = (uint32_t)size;
+  self->nwords++;
+}
+
+void content_tree_node_end_sentence(content_tree_node_t *self)
+{
+  uint64_t first = 0ul;
+
+  if (self->nsentences > 0ul)
+  {
+    first = self->sentences[self->nsentences - 1ul].first + self->sentences[self->nsentences - 1ul].count;
+  }
+
+  if (self->sentences == NULL)
+  {
+    self->sentcap = CONTENT_TREE_NODE_CAPACITY;
+    self->sentences = (content_sentence_t *)malloc(self->sentcap * sizeof(*self->sentences));
+  }
+  else if (self->nsentences >= self->sentcap)
+  {
+    void *__old = self->sentences;
+    self->sentences = NULL;
+    self->sentences = (content_sentence_t *)realloc(__old, (self->sentcap << 1) * sizeof(*self->sentences));
+    self->sentcap <<= 1;
+  }
+
+  if (self->sentences == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  self->sentences[self->nsentences].first = first;
+  self->sentences[self->nsentences].count = self->nwords - first;
+  self->nsentences++;
+}
+
+const content_word_t *content_tree_node_sentence(const content_tree_node_t *self, const uint64_t i, uint64_t *n)
+{
+  if (i >= self->nsentences)
+  {
+    *n = 0ul;
+    return NULL;
+  }
+
+  *n = self->sentences[i].count;
+  return self->words + self->sentences[i].first;
+}
+
 void content_tree_node_print(const content_tree_node_t *self)
 {
+  const content_word_t *words = NULL;
+  uint64_t n;
+  uint64_t i;
+  uint64_t j;
+
   // NOTE: Check for a ulong specifier ..
-  printf("%.*s\n", (int)self->size, (char *)self->data);
+  printf("%.*s\n", (int)self->size, (self->data != NULL) ? (const char *)self->data : "");
+
+  for (i = 0ul; i < self->nsentences; i++)
+  {
+    words = content_tree_node_sentence(self, i, &n);
+
+    for (j = 0ul; j < n; j++)
+    {
+      printf("%s%.*s", (j > 0ul) ? " " : "  ", (int)words[j].size, (const char *)self->data + words[j].offset);
+    }
+    printf("\n");
+  }
 }
 
 static void __content_tree_node_print(const content_tree_node_t *self)
@@ -152,7 +241,7 @@ content_tree_node_queue_t *content_tree_node_queue_new(const size_t cap)
 
 void content_tree_node_queue_destroy(content_tree_node_queue_t *self)
 {
-  if (self == NULL)
+  if (self != NULL)
   {
     free(self);
     self = NULL;
@@ -163,6 +252,8 @@ content_tree_node_queue_t *content_tree_node_queue_enqueue(content_tree_node_que
 {
   if ((self->w - self->r) >= self->cap)
   {
+    const size_t cap = self->cap;
+    const uint64_t k = self->r % cap;
     self->cap += CONTENT_TREE_NODE_QUEUE_CAPACITY;
     const size_t size = offsetof(content_tree_node_queue_t, nodes[self->cap]);
     void *__old = NULL;
@@ -174,6 +265,13 @@ content_tree_node_queue_t *content_tree_node_queue_enqueue(content_tree_node_que
       fprintf(stderr, "%s(): %s\n", __func__, "memory error");
       exit(EXIT_FAILURE);
     }
+
+    // NOTE: The oldest entries of a full ring run from 'k' to the end
+    //       of the old array; move them to the end of the new one so
+    //       the ring keeps its order under the larger capacity.
+    memmove(self->nodes + (self->cap - (cap - k)), self->nodes + k, (cap - k) * sizeof(*self->nodes));
+    self->r = self->cap - (cap - k);
+    self->w = self->r + cap;
   }
   self->nodes[self->w++ % self->cap] = node;
   return self;
@@ -5,12 +5,48 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#define CONTENT_TREE_NODE_CAPACITY (1ul << 12)
+#define CONTENT_TREE_NODE_CAPACITY  (1ul << 2)
+#define CONTENT_TREE_WORDS_CAPACITY (1ul << 5)
+
+/**
+ * @brief A word as a span of the text its node refers to. Spans are 32
+ *        bit, so a word must end within the first 4 GiB of the text.
+ */
+struct content_word
+{
+  uint32_t offset;
+  uint32_t size;
+};
+
+typedef struct content_word content_word_t;
 
+/**
+ * @brief A sentence as a run of consecutive entries in its node's words.
+ */
+struct content_sentence
+{
+  uint64_t first;
+  uint64_t count;
+};
+
+typedef struct content_sentence content_sentence_t;
+
+/**
+ * @brief The content of one body of text. The node refers to the text
+ *        rather than copying it, so the text must outlive the node; its
+ *        words and sentences live in one array each, and every array,
+ *        the children included, grows as needed.
+ */
 struct content_tree_node
 {
-  uint8_t *data;
+  const uint8_t *data;
   size_t size;
+  size_t wordcap;
+  uint64_t nwords;
+  content_word_t *words;
+  size_t sentcap;
+  uint64_t nsentences;
+  content_sentence_t *sentences;
   size_t cap;
   uint64_t count;
   struct content_tree_node *parent;
@@ -19,12 +55,31 @@ struct content_tree_node
 
 typedef struct content_tree_node content_tree_node_t;
 
+/**
+ * @brief Create a node over the text, with room for 'cap' children.
+ */
 content_tree_node_t *content_tree_node_new(const void *data, const size_t size, const size_t cap);
 
 void content_tree_node_destroy(content_tree_node_t *self);
 
 bool content_tree_node_append(content_tree_node_t *self, content_tree_node_t *node);
 
+/**
+ * @brief Add the word at 'offset' into the node's text.
+ */
+void content_tree_node_add_word(content_tree_node_t *self, const size_t offset, const size_t size);
+
+/**
+ * @brief End a sentence with the words added since the last one ended.
+ */
+void content_tree_node_end_sentence(content_tree_node_t *self);
+
+/**
+ * @brief Return the sentence's first word and, in 'n', how many follow
+ *        it in the node's words, itself included.
+ */
+const content_word_t *content_tree_node_sentence(const content_tree_node_t *self, const uint64_t i, uint64_t *n);
+
 void content_tree_node_print(const content_tree_node_t *self);
 
 #define CONTENT_TREE_NODE_QUEUE_CAPACITY (1ul << 5)
@@ -0,0 +1,520 @@
+/**
+ * Academic Free License ("AFL") v. 3.0
+ *
+ * Copyright 2024 Da'Jour J. Christophe. All rights reserved.
+ *
+ * This Academic Free License (the "License") applies to any original
+ * work of authorship (the "Original Work") whose owner (the "Licensor")
+ * has placed the following licensing notice adjacent to the copyright
+ * notice for the Original Work:
+ *
+ * Licensed under the Academic Free License version 3.0.
+ */
+#include "task.h"
+#include "tree.h"
+#include "vocab.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+struct text_tf_task
+{
+  content_tree_t **trees;
+  text_tf_t **out;
+  text_vocab_t *vocab;
+  uint32_t bits;
+  uint64_t begin;
+  uint64_t end;
+};
+
+typedef struct text_tf_task text_tf_task_t;
+
+uint64_t text_hash(const void *data, const size_t size)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  uint64_t hash = 0xcbf29ce484222325ul;
+  size_t i;
+
+  for (i = 0ul; i < size; i++)
+  {
+    hash ^= p[i];
+    hash *= 0x100000001b3ul;
+  }
+
+  return hash;
+}
+
+static text_vocab_table_t *text_vocab_table_new(const size_t cap)
+{
+  const size_t size = offsetof(text_vocab_table_t, slots[cap]);
+  text_vocab_table_t *self = NULL;
+  self = (text_vocab_table_t *)calloc(1ul, size);
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+  self->cap = cap;
+  return self;
+}
+
+text_vocab_t *text_vocab_new(const size_t cap)
+{
+  text_vocab_t *self = NULL;
+  size_t slots = TEXT_VOCAB_CAPACITY;
+
+  self = (text_vocab_t *)calloc(1ul, sizeof(*self));
+  if (self == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  if (0 != pthread_mutex_init(&self->lock, NULL))
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "could not initialize mutex");
+    exit(EXIT_FAILURE);
+  }
+
+  while (slots < (cap << 1))
+  {
+    slots <<= 1;
+  }
+
+  self->table = text_vocab_table_new(slots);
+  return self;
+}
+
+void text_vocab_destroy(text_vocab_t *self)
+{
+  text_vocab_table_t *table = NULL;
+  text_vocab_arena_t *arena = NULL;
+  uint64_t k;
+
+  if (self != NULL)
+  {
+    while (NULL != (table = self->table))
+    {
+      self->table = table->prev;
+      free(table);
+    }
+
+    while (NULL != (arena = self->arena))
+    {
+      self->arena = arena->prev;
+      free(arena);
+    }
+
+    for (k = 0ul; k < TEXT_VOCAB_CHUNKS; k++)
+    {
+      if (self->chunks[k] != NULL)
+      {
+        free(self->chunks[k]);
+        self->chunks[k] = NULL;
+      }
+    }
+
+    pthread_mutex_destroy(&self->lock);
+
+    free(self);
+    self = NULL;
+  }
+}
+
+uint64_t text_vocab_size(const text_vocab_t *self)
+{
+  return __atomic_load_n(&self->count, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Return the slot holding the word, or the empty slot where it
+ *        belongs. Slots only ever go from empty to full, so a probe that
+ *        meets an empty slot has seen every match there is.
+ */
+static text_term_t **text_vocab_probe(text_vocab_table_t *table, const uint64_t hash, const char *data, const size_t size)
+{
+  text_term_t *term = NULL;
+  uint64_t i;
+
+  for (i = hash & (table->cap - 1ul);; i = (i + 1ul) & (table->cap - 1ul))
+  {
+    term = __atomic_load_n(table->slots + i, __ATOMIC_ACQUIRE);
+    if (term == NULL)
+    {
+      return table->slots + i;
+    }
+
+    if (term->hash == hash && term->size == size && 0 == memcmp(term->data, data, size))
+    {
+      return table->slots + i;
+    }
+  }
+}
+
+uint32_t text_vocab_find(const text_vocab_t *self, const char *data, const size_t size)
+{
+  text_vocab_table_t *table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);
+  text_term_t *term = NULL;
+
+  term = __atomic_load_n(text_vocab_probe(table, text_hash(data, size), data, size), __ATOMIC_ACQUIRE);
+  return (term == NULL) ? UINT32_MAX : term->id;
+}
+
+static void *text_vocab_alloc(text_vocab_t *self, const size_t size)
+{
+  const size_t n = (size + 7ul) & ~7ul;
+  text_vocab_arena_t *arena = self->arena;
+  size_t cap = TEXT_VOCAB_ARENA_CAPACITY;
+  void *p = NULL;
+
+  if (arena == NULL || (arena->size + n) > arena->cap)
+  {
+    if (cap < n)
+    {
+      cap = n;
+    }
+
+    arena = (text_vocab_arena_t *)malloc(offsetof(text_vocab_arena_t, data[cap]));
+    if (arena == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+
+    arena->prev = self->arena;
+    arena->cap = cap;
+    arena->size = 0ul;
+    self->arena = arena;
+  }
+
+  p = arena->data + arena->size;
+  arena->size += n;
+  return p;
+}
+
+/**
+ * @brief Find the chunk of a term id and its index in the chunk.
+ */
+static uint64_t text_vocab_chunk(const uint32_t id, uint64_t *i)
+{
+  const uint64_t k = 63ul - (uint64_t)__builtin_clzll((uint64_t)id / TEXT_VOCAB_CHUNK + 1ul);
+
+  *i = (uint64_t)id - TEXT_VOCAB_CHUNK * ((1ul << k) - 1ul);
+  return k;
+}
+
+static void text_vocab_grow(text_vocab_t *self)
+{
+  text_vocab_table_t *old = self->table;
+  text_vocab_table_t *table = NULL;
+  text_term_t *term = NULL;
+  uint64_t i;
+
+  table = text_vocab_table_new(old->cap << 1);
+  table->prev = old;
+
+  for (i = 0ul; i < old->cap; i++)
+  {
+    if (NULL != (term = old->slots[i]))
+    {
+      *text_vocab_probe(table, term->hash, term->data, term->size) = term;
+    }
+  }
+
+  // NOTE: Readers still probing the old table find every term it had;
+  //       one that misses there looks again under the lock.
+  __atomic_store_n(&self->table, table, __ATOMIC_RELEASE);
+}
+
+uint32_t text_vocab_intern(text_vocab_t *self, const char *data, const size_t size)
+{
+  const uint64_t hash = text_hash(data, size);
+  text_vocab_table_t *table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);
+  text_term_t **slot = NULL;
+  text_term_t *term = NULL;
+  uint64_t k;
+  uint64_t i;
+
+  slot = text_vocab_probe(table, hash, data, size);
+  if (NULL != (term = __atomic_load_n(slot, __ATOMIC_ACQUIRE)))
+  {
+    return term->id;
+  }
+
+  pthread_mutex_lock(&self->lock);
+
+  if (((self->count + 1ul) << 1) > self->table->cap)
+  {
+    text_vocab_grow(self);
+  }
+
+  slot = text_vocab_probe(self->table, hash, data, size);
+  if (NULL != (term = *slot))
+  {
+    pthread_mutex_unlock(&self->lock);
+    return term->id;
+  }
+
+  if (self->count >= UINT32_MAX)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "vocabulary full");
+    exit(EXIT_FAILURE);
+  }
+
+  term = (text_term_t *)text_vocab_alloc(self, offsetof(text_term_t, data) + size);
+  term->hash = hash;
+  term->id = (uint32_t)self->count;
+  term->size = (uint32_t)size;
+  memcpy(term->data, data, size);
+
+  k = text_vocab_chunk(term->id, &i);
+  if (self->chunks[k] == NULL)
+  {
+    self->chunks[k] = (text_term_t **)malloc((TEXT_VOCAB_CHUNK << k) * sizeof(*self->chunks[k]));
+    if (self->chunks[k] == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+  }
+  self->chunks[k][i] = term;
+
+  __atomic_store_n(slot, term, __ATOMIC_RELEASE);
+  __atomic_store_n(&self->count, self->count + 1ul, __ATOMIC_RELEASE);
+
+  pthread_mutex_unlock(&self->lock);
+  return term->id;
+}
+
+const char *text_vocab_term(const text_vocab_t *self, const uint32_t id, size_t *size)
+{
+  const text_term_t *term = NULL;
+  uint64_t k;
+  uint64_t i;
+
+  if ((uint64_t)id >= text_vocab_size(self))
+  {
+    *size = 0ul;
+    return NULL;
+  }
+
+  k = text_vocab_chunk(id, &i);
+  term = self->chunks[k][i];
+
+  *size = term->size;
+  return term->data;
+}
+
+void text_lower(char *dst, const char *src, const size_t size)
+{
+  size_t i = 0ul;
+
+#if defined(__SSE2__)
+  const __m128i lo = _mm_set1_epi8('A' - 1);
+  const __m128i hi = _mm_set1_epi8('Z' + 1);
+  const __m128i bit = _mm_set1_epi8(0x20);
+
+  // NOTE: Bytes above ASCII are negative to the signed compares, so
+  //       only 'A' to 'Z' get the case bit.
+  for (; (i + 16ul) <= size; i += 16ul)
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+    const __m128i m = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(v, _mm_and_si128(m, bit)));
+  }
+#endif
+
+  for (; i < size; i++)
+  {
+    dst[i] = (src[i] >= 'A' && src[i] <= 'Z') ? (char)(src[i] | 0x20) : src[i];
+  }
+}
+
+static int text_tf_compare(const void *a, const void *b)
+{
+  const uint32_t x = *(const uint32_t *)a;
+  const uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+text_tf_t *text_tf_new(const content_tree_t *tree, text_vocab_t *vocab, const uint32_t bits)
+{
+  const uint32_t mask = (bits >= 32u) ? UINT32_MAX : ((1u << bits) - 1u);
+  content_tree_node_queue_t *que = NULL;
+  content_tree_node_t *node = NULL;
+  const content_word_t *word = NULL;
+  text_tf_t *self = NULL;
+  uint32_t *ids = NULL;
+  char *buf = NULL;
+  size_t bufcap = 0ul;
+  size_t cap = TEXT_TF_CAPACITY;
+  uint64_t n = 0ul;
+  uint64_t i;
+  uint64_t j;
+  void *__old = NULL;
+
+  self = (text_tf_t *)calloc(1ul, sizeof(*self));
+  ids = (uint32_t *)malloc(cap * sizeof(*ids));
+  if (self == NULL || ids == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  que = content_tree_node_queue_new(CONTENT_TREE_NODE_QUEUE_CAPACITY);
+  if (tree != NULL && tree->root != NULL)
+  {
+    que = content_tree_node_queue_enqueue(que, tree->root);
+  }
+
+  while (NULL != (node = content_tree_node_queue_dequeue(que)))
+  {
+    if ((n + node->nwords) > cap)
+    {
+      while ((n + node->nwords) > cap)
+      {
+        cap <<= 1;
+      }
+
+      __old = ids;
+      ids = NULL;
+      ids = (uint32_t *)realloc(__old, cap * sizeof(*ids));
+      if (ids == NULL)
+      {
+        fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    for (i = 0ul; i < node->nwords; i++)
+    {
+      word = node->words + i;
+
+      if (word->size > bufcap)
+      {
+        bufcap = (word->size + 63ul) & ~63ul;
+        __old = buf;
+        buf = NULL;
+        buf = (char *)realloc(__old, bufcap);
+        if (buf == NULL)
+        {
+          fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+          exit(EXIT_FAILURE);
+        }
+      }
+
+      text_lower(buf, (const char *)node->data + word->offset, word->size);
+
+      if (vocab != NULL)
+      {
+        ids[n++] = text_vocab_intern(vocab, buf, word->size);
+      }
+      else
+      {
+        ids[n++] = (uint32_t)text_hash(buf, word->size) & mask;
+      }
+    }
+
+    for (i = 0ul; i < node->count; i++)
+    {
+      if (node->children[i] != NULL)
+      {
+        que = content_tree_node_queue_enqueue(que, node->children[i]);
+      }
+    }
+  }
+
+  content_tree_node_queue_destroy(que);
+  free(buf);
+
+  qsort(ids, n, sizeof(*ids), &text_tf_compare);
+
+  for (i = 0ul; i < n; i++)
+  {
+    self->count += (i == 0ul || ids[i] != ids[i - 1ul]);
+  }
+
+  self->cap = (self->count > 0ul) ? self->count : 1ul;
+  self->total = n;
+  self->ids = (uint32_t *)malloc(self->cap * sizeof(*self->ids));
+  self->counts = (uint32_t *)malloc(self->cap * sizeof(*self->counts));
+  if (self->ids == NULL || self->counts == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0ul, j = 0ul; i < n; i++)
+  {
+    if (i == 0ul || ids[i] != ids[i - 1ul])
+    {
+      self->ids[j] = ids[i];
+      self->counts[j++] = 0u;
+    }
+    self->counts[j - 1ul]++;
+  }
+
+  free(ids);
+  return self;
+}
+
+void text_tf_destroy(text_tf_t *self)
+{
+  if (self != NULL)
+  {
+    free(self->ids);
+    self->ids = NULL;
+
+    free(self->counts);
+    self->counts = NULL;
+
+    free(self);
+    self = NULL;
+  }
+}
+
+static void text_tf_task(void *arg)
+{
+  text_tf_task_t *self = (text_tf_task_t *)arg;
+  uint64_t i;
+
+  for (i = self->begin; i < self->end; i++)
+  {
+    self->out[i] = text_tf_new(self->trees[i], self->vocab, self->bits);
+  }
+}
+
+void text_tf_run(content_tree_t **trees, text_tf_t **out, const uint64_t n, text_vocab_t *vocab, const uint32_t bits, const uint64_t nthreads)
+{
+  const uint64_t ntasks = (n + TEXT_TF_TASK_CHUNK - 1ul) / TEXT_TF_TASK_CHUNK;
+  text_tf_task_t *tasks = NULL;
+  uint64_t i;
+
+  tasks = (text_tf_task_t *)malloc((ntasks + 1ul) * sizeof(*tasks));
+  if (tasks == NULL)
+  {
+    fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0ul; i < ntasks; i++)
+  {
+    tasks[i].trees = trees;
+    tasks[i].out = out;
+    tasks[i].vocab = vocab;
+    tasks[i].bits = bits;
+    tasks[i].begin = i * TEXT_TF_TASK_CHUNK;
+    tasks[i].end = (n < (i + 1ul) * TEXT_TF_TASK_CHUNK) ? n : ((i + 1ul) * TEXT_TF_TASK_CHUNK);
+  }
+
+  task_run(&text_tf_task, tasks, sizeof(*tasks), ntasks, nthreads);
+  free(tasks);
+}
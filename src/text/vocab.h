@@ -0,0 +1,147 @@
+#ifndef TEXT_VOCAB_H
+#define TEXT_VOCAB_H
+
+#include "tree.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEXT_VOCAB_CAPACITY       (1ul << 12)
+#define TEXT_VOCAB_ARENA_CAPACITY (1ul << 16)
+
+/**
+ * @brief Term ids index a list of chunks, chunk 'k' holding CHUNK << k
+ *        terms, so the terms of a full list never have to move.
+ */
+#define TEXT_VOCAB_CHUNK  (1ul << 10)
+#define TEXT_VOCAB_CHUNKS 32ul
+
+#define TEXT_TF_CAPACITY (1ul << 6)
+
+/**
+ * @brief Documents per task of text_tf_run().
+ */
+#define TEXT_TF_TASK_CHUNK (1ul << 2)
+
+/**
+ * @brief A term as stored in the arena. The bytes follow the record.
+ */
+struct text_term
+{
+  uint64_t hash;
+  uint32_t id;
+  uint32_t size;
+  char data[];
+};
+
+typedef struct text_term text_term_t;
+
+/**
+ * @brief An open addressing table of term pointers. A grown table links
+ *        to the one it replaced, which is kept for readers still in it.
+ */
+struct text_vocab_table
+{
+  struct text_vocab_table *prev;
+  size_t cap;
+  text_term_t *slots[];
+};
+
+typedef struct text_vocab_table text_vocab_table_t;
+
+struct text_vocab_arena
+{
+  struct text_vocab_arena *prev;
+  size_t cap;
+  size_t size;
+  uint8_t data[];
+};
+
+typedef struct text_vocab_arena text_vocab_arena_t;
+
+/**
+ * @brief Maps words to dense term ids. Terms are only ever added and
+ *        never move, so lookups run without a lock on any thread; adding
+ *        a term takes the lock, looks again and publishes the term once
+ *        it is complete.
+ */
+struct text_vocab
+{
+  pthread_mutex_t lock;
+  text_vocab_table_t *table;
+  text_vocab_arena_t *arena;
+  uint64_t count;
+  text_term_t **chunks[TEXT_VOCAB_CHUNKS];
+};
+
+typedef struct text_vocab text_vocab_t;
+
+/**
+ * @brief Create a vocabulary with room for about 'cap' terms before its
+ *        table grows.
+ */
+text_vocab_t *text_vocab_new(const size_t cap);
+
+void text_vocab_destroy(text_vocab_t *self);
+
+uint64_t text_vocab_size(const text_vocab_t *self);
+
+/**
+ * @brief Return the id of the word, adding it when it is new.
+ */
+uint32_t text_vocab_intern(text_vocab_t *self, const char *data, const size_t size);
+
+/**
+ * @brief Return the id of the word, or UINT32_MAX when it is unknown.
+ */
+uint32_t text_vocab_find(const text_vocab_t *self, const char *data, const size_t size);
+
+/**
+ * @brief Return the word of a term id and, in 'size', its length.
+ */
+const char *text_vocab_term(const text_vocab_t *self, const uint32_t id, size_t *size);
+
+/**
+ * @brief The 64 bit FNV-1a hash of the bytes, which the vocabulary keys
+ *        its terms by and which hashes words everywhere else in the text
+ *        module.
+ */
+uint64_t text_hash(const void *data, const size_t size);
+
+/**
+ * @brief Copy the bytes into 'dst' with the ASCII letters lowercased.
+ *        Other bytes are copied as they are.
+ */
+void text_lower(char *dst, const char *src, const size_t size);
+
+/**
+ * @brief A sparse term frequency vector, sorted by term id.
+ */
+struct text_tf
+{
+  size_t cap;
+  uint64_t count;
+  uint64_t total;
+  uint32_t *ids;
+  uint32_t *counts;
+};
+
+typedef struct text_tf text_tf_t;
+
+/**
+ * @brief Count the lowercased words of every node of the tree. With a
+ *        vocabulary the ids are its term ids; without one, each word is
+ *        hashed into one of 1 << 'bits' buckets.
+ */
+text_tf_t *text_tf_new(const content_tree_t *tree, text_vocab_t *vocab, const uint32_t bits);
+
+void text_tf_destroy(text_tf_t *self);
+
+/**
+ * @brief Build the vectors of 'n' trees into 'out' on up to 'nthreads'
+ *        threads, all of them sharing the vocabulary.
+ */
+void text_tf_run(content_tree_t **trees, text_tf_t **out, const uint64_t n, text_vocab_t *vocab, const uint32_t bits, const uint64_t nthreads);
+
+#endif/*TEXT_VOCAB_H*/
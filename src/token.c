@@ -87,7 +87,7 @@ void token_print(const token_t *self)
       break;
 
     case KIND_WORD:
-      printf("%s", (char *)self->data);
+      printf("%.*s", (int)self->size, (char *)self->data);
       break;
 
     case KIND_DASH:
@@ -139,6 +139,37 @@ bool token_queue_enqueue_back(token_queue_t *self, token_t *tok)
   return true;
 }
 
+token_queue_t *token_queue_append(token_queue_t *self, const token_t *tok)
+{
+  if ((self->w - self->r) >= self->cap)
+  {
+    const size_t cap = self->cap << 1;
+    const size_t size = offsetof(token_queue_t, toks[cap]);
+    token_queue_t *que = NULL;
+    uint64_t i;
+
+    que = (token_queue_t *)malloc(size);
+    if (que == NULL)
+    {
+      fprintf(stderr, "%s(): %s\n", __func__, "memory error");
+      exit(EXIT_FAILURE);
+    }
+    token_queue_setup(que, offsetof(token_queue_t, toks), cap);
+
+    // NOTE: The ring may wrap, so the tokens are copied out in order
+    //       rather than reallocating in place.
+    for (i = self->r; i != self->w; i++)
+    {
+      memcpy((que->toks + que->w++), (self->toks + (i % self->cap)), sizeof(*self->toks));
+    }
+
+    token_queue_destroy(self);
+    self = que;
+  }
+  memcpy((self->toks + (self->w++ % self->cap)), tok, sizeof(*self->toks));
+  return self;
+}
+
 bool token_queue_enqueue_front(token_queue_t *self, token_t *tok)
 {
   if ((self->w - self->r) >= self->cap)
@@ -185,3 +216,8 @@ bool token_queue_next(token_queue_t *self)
   self->w++;
   return true;
 }
+
+size_t token_queue_size(const token_queue_t *self)
+{
+  return self->w - self->r;
+}
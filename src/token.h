@@ -65,6 +65,12 @@ void token_queue_destroy(token_queue_t *self);
 
 bool token_queue_enqueue_back(token_queue_t *self, token_t *tok);
 
+/**
+ * @brief Enqueue a token at the back of the queue, growing the queue
+ *        when it is full.
+ */
+token_queue_t *token_queue_append(token_queue_t *self, const token_t *tok);
+
 bool token_queue_enqueue_front(token_queue_t *self, token_t *tok);
 
 token_t *token_queue_peek(token_queue_t *self);
@@ -75,4 +81,6 @@ token_t *token_queue_current(token_queue_t *self);
 
 bool token_queue_next(token_queue_t *self);
 
+size_t token_queue_size(const token_queue_t *self);
+
 #endif/*TOKEN_H*/